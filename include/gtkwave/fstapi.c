@@ -783,6 +783,7 @@ unsigned section_header_only : 1;
 unsigned flush_context_pending : 1;
 unsigned parallel_enabled : 1;
 unsigned parallel_was_enabled : 1;
+unsigned int parallel_workers; /* compression threads per section, see fstWriterSetParallelWorkers() */
 
 /* should really be semaphores, but are bytes to cut down on read-modify-write window size */
 unsigned char already_in_flush; /* in case control-c handlers interrupt */
@@ -1265,6 +1266,358 @@ if(xc)
 }
 
 
+/*
+ * pack the value change chain of one handle, building it backwards
+ * from the end of scratchpad (which is vchg_siz bytes); returns the start
+ */
+static unsigned char *fstWriterPackChain(struct fstWriterContext *xc, uint32_t *vm4ip, unsigned char *scratchpad)
+{
+unsigned char *vchg_mem = xc->vchg_mem;
+unsigned char *scratchpnt;
+uint32_t offs = vm4ip[2];
+uint32_t next_offs;
+unsigned int wrlen;
+
+
+scratchpnt = scratchpad + xc->vchg_siz;         /* build this buffer backwards */
+if(vm4ip[1] <= 1)
+        {
+        if(vm4ip[1] == 1)
+                {
+                wrlen = fstGetVarint32Length(vchg_mem + offs + 4); /* used to advance and determine wrlen */
+#ifndef FST_REMOVE_DUPLICATE_VC
+                xc->curval_mem[vm4ip[0]] = vchg_mem[offs + 4 + wrlen]; /* checkpoint variable */
+#endif
+                while(offs)
+                        {
+                        unsigned char val;
+                        uint32_t time_delta, rcv;
+                        next_offs = fstGetUint32(vchg_mem + offs);
+                        offs += 4;
+
+                        time_delta = fstGetVarint32(vchg_mem + offs, (int *)&wrlen);
+                        val = vchg_mem[offs+wrlen];
+                        offs = next_offs;
+
+                        switch(val)
+                                {
+                                case '0':
+                                case '1':               rcv = ((val&1)<<1) | (time_delta<<2);
+                                                        break; /* pack more delta bits in for 0/1 vchs */
+
+                                case 'x': case 'X':     rcv = FST_RCV_X | (time_delta<<4); break;
+                                case 'z': case 'Z':     rcv = FST_RCV_Z | (time_delta<<4); break;
+                                case 'h': case 'H':     rcv = FST_RCV_H | (time_delta<<4); break;
+                                case 'u': case 'U':     rcv = FST_RCV_U | (time_delta<<4); break;
+                                case 'w': case 'W':     rcv = FST_RCV_W | (time_delta<<4); break;
+                                case 'l': case 'L':     rcv = FST_RCV_L | (time_delta<<4); break;
+                                default:                rcv = FST_RCV_D | (time_delta<<4); break;
+                                }
+
+                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, rcv);
+                        }
+                }
+                else
+                {
+                /* variable length */
+                /* fstGetUint32 (next_offs) + fstGetVarint32 (time_delta) + fstGetVarint32 (len) + payload */
+                unsigned char *pnt;
+                uint32_t record_len;
+                uint32_t time_delta;
+
+                while(offs)
+                        {
+                        next_offs = fstGetUint32(vchg_mem + offs);
+                        offs += 4;
+                        pnt = vchg_mem + offs;
+                        offs = next_offs;
+                        time_delta = fstGetVarint32(pnt, (int *)&wrlen);
+                        pnt += wrlen;
+                        record_len = fstGetVarint32(pnt, (int *)&wrlen);
+                        pnt += wrlen;
+
+                        scratchpnt -= record_len;
+                        memcpy(scratchpnt, pnt, record_len);
+
+                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, record_len);
+                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1)); /* reserve | 1 case for future expansion */
+                        }
+                }
+        }
+        else
+        {
+        wrlen = fstGetVarint32Length(vchg_mem + offs + 4); /* used to advance and determine wrlen */
+#ifndef FST_REMOVE_DUPLICATE_VC
+        memcpy(xc->curval_mem + vm4ip[0], vchg_mem + offs + 4 + wrlen, vm4ip[1]); /* checkpoint variable */
+#endif
+        while(offs)
+                {
+                unsigned int idx;
+                char is_binary = 1;
+                unsigned char *pnt;
+                uint32_t time_delta;
+
+                next_offs = fstGetUint32(vchg_mem + offs);
+                offs += 4;
+
+                time_delta = fstGetVarint32(vchg_mem + offs, (int *)&wrlen);
+
+                pnt = vchg_mem+offs+wrlen;
+                offs = next_offs;
+
+                for(idx=0;idx<vm4ip[1];idx++)
+                        {
+                        if((pnt[idx] == '0') || (pnt[idx] == '1'))
+                                {
+                                continue;
+                                }
+                                else
+                                {
+                                is_binary = 0;
+                                break;
+                                }
+                        }
+
+                if(is_binary)
+                        {
+                        unsigned char acc = 0;
+                        /* new algorithm */
+                        idx = ((vm4ip[1]+7) & ~7);
+                        switch(vm4ip[1] & 7)
+                                {
+                                case 0: do {    acc  = (pnt[idx+7-8] & 1) << 0; /* fallthrough */
+                                case 7:         acc |= (pnt[idx+6-8] & 1) << 1; /* fallthrough */
+                                case 6:         acc |= (pnt[idx+5-8] & 1) << 2; /* fallthrough */
+                                case 5:         acc |= (pnt[idx+4-8] & 1) << 3; /* fallthrough */
+                                case 4:         acc |= (pnt[idx+3-8] & 1) << 4; /* fallthrough */
+                                case 3:         acc |= (pnt[idx+2-8] & 1) << 5; /* fallthrough */
+                                case 2:         acc |= (pnt[idx+1-8] & 1) << 6; /* fallthrough */
+                                case 1:         acc |= (pnt[idx+0-8] & 1) << 7;
+                                                *(--scratchpnt) = acc;
+                                                idx -= 8;
+                                        } while(idx);
+                                }
+
+                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1));
+                        }
+                        else
+                        {
+                        scratchpnt -= vm4ip[1];
+                        memcpy(scratchpnt, pnt, vm4ip[1]);
+
+                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1) | 1);
+                        }
+                }
+        }
+
+
+return(scratchpnt);
+}
+
+
+/*
+ * compress a packed value change chain, returning the data to write
+ * after the fstWriterVarint of *dhdrp (the uncompressed length, or 0 if not compressed)
+ */
+static unsigned char *fstWriterPackCompress(struct fstWriterContext *xc, unsigned char *scratchpnt, uint32_t wrlen,
+        unsigned char **packmemp, unsigned int *packmemlenp, uint32_t *dlenp, uint32_t *dhdrp)
+{
+*dlenp = wrlen;
+*dhdrp = 0;
+
+if(wrlen > 32)
+        {
+        unsigned long destlen = wrlen;
+        unsigned char *dmem;
+        unsigned int rc;
+
+        if(!xc->fastpack)
+                {
+                if(wrlen <= *packmemlenp)
+                        {
+                        dmem = *packmemp;
+                        }
+                        else
+                        {
+                        free(*packmemp);
+                        dmem = *packmemp = (unsigned char *)malloc(compressBound(*packmemlenp = wrlen));
+                        }
+
+                rc = compress2(dmem, &destlen, scratchpnt, wrlen, 4);
+                if(rc == Z_OK)
+                        {
+                        *dlenp = destlen;
+                        *dhdrp = wrlen;
+                        return(dmem);
+                        }
+                }
+                else
+                {
+                /* this is extremely conservative: fastlz needs +5% for worst case, lz4 needs siz+(siz/255)+16 */
+                if(((wrlen * 2) + 2) <= *packmemlenp)
+                        {
+                        dmem = *packmemp;
+                        }
+                        else
+                        {
+                        free(*packmemp);
+                        dmem = *packmemp = (unsigned char *)malloc(*packmemlenp = (wrlen * 2) + 2);
+                        }
+
+                rc = (xc->fourpack) ? LZ4_compress((char *)scratchpnt, (char *)dmem, wrlen) : fastlz_compress(scratchpnt, wrlen, dmem);
+                if(rc < destlen)
+                        {
+                        *dlenp = rc;
+                        *dhdrp = wrlen;
+                        return(dmem);
+                        }
+                }
+        }
+
+return(scratchpnt);
+}
+
+
+#ifdef FST_WRITER_PARALLEL
+/*
+ * with fstWriterSetParallelWorkers(), the value change chains of a
+ * section are packed and compressed by several worker threads, each
+ * taking ranges of handles; the results are then written in handle
+ * order, so the file is identical to one written by a single thread
+ */
+struct fstWriterPackRange
+{
+uint32_t first;                 /* first handle index in range */
+uint32_t last;                  /* one past last handle index in range */
+unsigned char *mem;             /* data to write for each handle */
+uint32_t mem_siz;
+uint32_t mem_alloc;
+uint32_t *recs;                 /* per handle: offset in mem, data length, dhdr, uncompressed length */
+};
+
+struct fstWriterPackJob
+{
+struct fstWriterContext *xc;
+struct fstWriterPackRange *ranges;
+unsigned int num_ranges;
+unsigned int next_range;
+pthread_mutex_t mutex;
+};
+
+
+static void *fstWriterPackWorker(void *arg)
+{
+struct fstWriterPackJob *job = (struct fstWriterPackJob *)arg;
+struct fstWriterContext *xc = job->xc;
+unsigned char *scratchpad = (unsigned char *)malloc(xc->vchg_siz);
+unsigned int packmemlen = 1024;
+unsigned char *packmem = (unsigned char *)malloc(packmemlen);
+
+for(;;)
+        {
+        struct fstWriterPackRange *r = NULL;
+        uint32_t i;
+
+        pthread_mutex_lock(&job->mutex);
+        if(job->next_range < job->num_ranges)
+                {
+                r = &job->ranges[job->next_range++];
+                }
+        pthread_mutex_unlock(&job->mutex);
+        if(!r) break;
+
+        for(i=r->first;i<r->last;i++)
+                {
+                uint32_t *vm4ip = &(xc->valpos_mem[4*i]);
+
+                if(vm4ip[2])
+                        {
+                        uint32_t *rec = &r->recs[4*(i - r->first)];
+                        unsigned char *scratchpnt = fstWriterPackChain(xc, vm4ip, scratchpad);
+                        uint32_t wrlen = scratchpad + xc->vchg_siz - scratchpnt;
+                        uint32_t dlen, dhdr;
+                        unsigned char *dmem = fstWriterPackCompress(xc, scratchpnt, wrlen, &packmem, &packmemlen, &dlen, &dhdr);
+
+                        if(r->mem_siz + dlen > r->mem_alloc)
+                                {
+                                r->mem_alloc = (r->mem_siz + dlen) * 2;
+                                r->mem = (unsigned char *)realloc(r->mem, r->mem_alloc);
+                                }
+                        memcpy(r->mem + r->mem_siz, dmem, dlen);
+                        rec[0] = r->mem_siz;
+                        rec[1] = dlen;
+                        rec[2] = dhdr;
+                        rec[3] = wrlen;
+                        r->mem_siz += dlen;
+                        }
+                }
+        }
+
+free(packmem);
+free(scratchpad);
+return(NULL);
+}
+
+
+/*
+ * pack and compress all value change chains of the section in parallel
+ */
+static struct fstWriterPackJob *fstWriterPackParallel(struct fstWriterContext *xc)
+{
+struct fstWriterPackJob *job = (struct fstWriterPackJob *)calloc(1, sizeof(struct fstWriterPackJob));
+unsigned int workers = xc->parallel_workers;
+pthread_t *threads = (pthread_t *)calloc(workers, sizeof(pthread_t));
+uint32_t range_siz;
+unsigned int i;
+
+job->xc = xc;
+job->num_ranges = workers * 8; /* several per worker, to balance the load */
+if(job->num_ranges > xc->maxhandle) job->num_ranges = xc->maxhandle ? xc->maxhandle : 1;
+range_siz = (xc->maxhandle + job->num_ranges - 1) / job->num_ranges;
+if(!range_siz) range_siz = 1;
+job->ranges = (struct fstWriterPackRange *)calloc(job->num_ranges, sizeof(struct fstWriterPackRange));
+for(i=0;i<job->num_ranges;i++)
+        {
+        struct fstWriterPackRange *r = &job->ranges[i];
+        r->first = i * range_siz;
+        r->last = r->first + range_siz;
+        if(r->first > xc->maxhandle) r->first = xc->maxhandle;
+        if(r->last > xc->maxhandle) r->last = xc->maxhandle;
+        r->recs = (uint32_t *)calloc((r->last - r->first) * 4 + 1, sizeof(uint32_t));
+        }
+pthread_mutex_init(&job->mutex, NULL);
+
+for(i=0;i<workers;i++)
+        {
+        pthread_create(&threads[i], NULL, fstWriterPackWorker, job);
+        }
+for(i=0;i<workers;i++)
+        {
+        pthread_join(threads[i], NULL);
+        }
+
+pthread_mutex_destroy(&job->mutex);
+free(threads);
+return(job);
+}
+
+
+static void fstWriterPackFree(struct fstWriterPackJob *job)
+{
+unsigned int i;
+
+for(i=0;i<job->num_ranges;i++)
+        {
+        free(job->ranges[i].mem);
+        free(job->ranges[i].recs);
+        }
+free(job->ranges);
+free(job);
+}
+#endif
+
+
+
 /*
  * only to be called directly by fst code...otherwise must
  * be synced up with time changes
@@ -1279,7 +1632,6 @@ static void fstWriterFlushContextPrivate(void *ctx)
 int cnt = 0;
 #endif
 unsigned int i;
-unsigned char *vchg_mem;
 FILE *f;
 off_t fpos, indxpos, endpos;
 uint32_t prevpos;
@@ -1295,6 +1647,8 @@ uint32_t *vm4ip;
 struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
 #ifdef FST_WRITER_PARALLEL
 struct fstWriterContext *xc2 = xc->xc_parent;
+struct fstWriterPackJob *packjob = NULL;
+uint32_t packjob_range_siz = 1;
 #else
 struct fstWriterContext *xc2 = xc;
 #endif
@@ -1315,9 +1669,19 @@ if((xc->vchg_siz <= 1)||(xc->already_in_flush)) return;
 xc->already_in_flush = 1; /* should really do this with a semaphore */
 
 xc->section_header_only = 0;
-scratchpad = (unsigned char *)malloc(xc->vchg_siz);
+scratchpad = NULL;
 
-vchg_mem = xc->vchg_mem;
+#ifdef FST_WRITER_PARALLEL
+if((xc->parallel_workers > 1) && (xc->maxhandle > 1))
+        {
+        packjob = fstWriterPackParallel(xc);
+        packjob_range_siz = packjob->ranges[0].last - packjob->ranges[0].first;
+        }
+        else
+#endif
+        {
+        scratchpad = (unsigned char *)malloc(xc->vchg_siz);
+        }
 
 f = xc->handle;
 fstWriterVarint(f, xc->maxhandle);      /* emit current number of handles */
@@ -1333,281 +1697,50 @@ for(i=0;i<xc->maxhandle;i++)
 
         if(vm4ip[2])
                 {
-                uint32_t offs = vm4ip[2];
-                uint32_t next_offs;
                 unsigned int wrlen;
-
-                vm4ip[2] = fpos;
-
-                scratchpnt = scratchpad + xc->vchg_siz;         /* build this buffer backwards */
-                if(vm4ip[1] <= 1)
-                        {
-                        if(vm4ip[1] == 1)
-                                {
-                                wrlen = fstGetVarint32Length(vchg_mem + offs + 4); /* used to advance and determine wrlen */
-#ifndef FST_REMOVE_DUPLICATE_VC
-                                xc->curval_mem[vm4ip[0]] = vchg_mem[offs + 4 + wrlen]; /* checkpoint variable */
+                unsigned char *dmem;
+                uint32_t dlen, dhdr;
+#ifndef FST_DYNAMIC_ALIAS_DISABLE
+                PPvoid_t pv;
 #endif
-                                while(offs)
-                                        {
-                                        unsigned char val;
-                                        uint32_t time_delta, rcv;
-                                        next_offs = fstGetUint32(vchg_mem + offs);
-                                        offs += 4;
-
-                                        time_delta = fstGetVarint32(vchg_mem + offs, (int *)&wrlen);
-                                        val = vchg_mem[offs+wrlen];
-                                        offs = next_offs;
-
-                                        switch(val)
-                                                {
-                                                case '0':
-                                                case '1':               rcv = ((val&1)<<1) | (time_delta<<2);
-                                                                        break; /* pack more delta bits in for 0/1 vchs */
-
-                                                case 'x': case 'X':     rcv = FST_RCV_X | (time_delta<<4); break;
-                                                case 'z': case 'Z':     rcv = FST_RCV_Z | (time_delta<<4); break;
-                                                case 'h': case 'H':     rcv = FST_RCV_H | (time_delta<<4); break;
-                                                case 'u': case 'U':     rcv = FST_RCV_U | (time_delta<<4); break;
-                                                case 'w': case 'W':     rcv = FST_RCV_W | (time_delta<<4); break;
-                                                case 'l': case 'L':     rcv = FST_RCV_L | (time_delta<<4); break;
-                                                default:                rcv = FST_RCV_D | (time_delta<<4); break;
-                                                }
-
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, rcv);
-                                        }
-                                }
-                                else
-                                {
-                                /* variable length */
-                                /* fstGetUint32 (next_offs) + fstGetVarint32 (time_delta) + fstGetVarint32 (len) + payload */
-                                unsigned char *pnt;
-                                uint32_t record_len;
-                                uint32_t time_delta;
 
-                                while(offs)
-                                        {
-                                        next_offs = fstGetUint32(vchg_mem + offs);
-                                        offs += 4;
-                                        pnt = vchg_mem + offs;
-                                        offs = next_offs;
-                                        time_delta = fstGetVarint32(pnt, (int *)&wrlen);
-                                        pnt += wrlen;
-                                        record_len = fstGetVarint32(pnt, (int *)&wrlen);
-                                        pnt += wrlen;
-
-                                        scratchpnt -= record_len;
-                                        memcpy(scratchpnt, pnt, record_len);
-
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, record_len);
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1)); /* reserve | 1 case for future expansion */
-                                        }
-                                }
+#ifdef FST_WRITER_PARALLEL
+                if(packjob)
+                        {
+                        struct fstWriterPackRange *r = &packjob->ranges[i / packjob_range_siz];
+                        uint32_t *rec = &r->recs[4*(i - r->first)];
+                        dmem = r->mem + rec[0];
+                        dlen = rec[1];
+                        dhdr = rec[2];
+                        wrlen = rec[3];
                         }
                         else
-                        {
-                        wrlen = fstGetVarint32Length(vchg_mem + offs + 4); /* used to advance and determine wrlen */
-#ifndef FST_REMOVE_DUPLICATE_VC
-                        memcpy(xc->curval_mem + vm4ip[0], vchg_mem + offs + 4 + wrlen, vm4ip[1]); /* checkpoint variable */
 #endif
-                        while(offs)
-                                {
-                                unsigned int idx;
-                                char is_binary = 1;
-                                unsigned char *pnt;
-                                uint32_t time_delta;
-
-                                next_offs = fstGetUint32(vchg_mem + offs);
-                                offs += 4;
-
-                                time_delta = fstGetVarint32(vchg_mem + offs, (int *)&wrlen);
-
-                                pnt = vchg_mem+offs+wrlen;
-                                offs = next_offs;
-
-                                for(idx=0;idx<vm4ip[1];idx++)
-                                        {
-                                        if((pnt[idx] == '0') || (pnt[idx] == '1'))
-                                                {
-                                                continue;
-                                                }
-                                                else
-                                                {
-                                                is_binary = 0;
-                                                break;
-                                                }
-                                        }
-
-                                if(is_binary)
-                                        {
-                                        unsigned char acc = 0;
-                                        /* new algorithm */
-                                        idx = ((vm4ip[1]+7) & ~7);
-                                        switch(vm4ip[1] & 7)
-                                                {
-                                                case 0: do {    acc  = (pnt[idx+7-8] & 1) << 0; /* fallthrough */
-                                                case 7:         acc |= (pnt[idx+6-8] & 1) << 1; /* fallthrough */
-                                                case 6:         acc |= (pnt[idx+5-8] & 1) << 2; /* fallthrough */
-                                                case 5:         acc |= (pnt[idx+4-8] & 1) << 3; /* fallthrough */
-                                                case 4:         acc |= (pnt[idx+3-8] & 1) << 4; /* fallthrough */
-                                                case 3:         acc |= (pnt[idx+2-8] & 1) << 5; /* fallthrough */
-                                                case 2:         acc |= (pnt[idx+1-8] & 1) << 6; /* fallthrough */
-                                                case 1:         acc |= (pnt[idx+0-8] & 1) << 7;
-                                                                *(--scratchpnt) = acc;
-                                                                idx -= 8;
-                                                        } while(idx);
-                                                }
-
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1));
-                                        }
-                                        else
-                                        {
-                                        scratchpnt -= vm4ip[1];
-                                        memcpy(scratchpnt, pnt, vm4ip[1]);
-
-                                        scratchpnt = fstCopyVarint32ToLeft(scratchpnt, (time_delta << 1) | 1);
-                                        }
-                                }
+                        {
+                        scratchpnt = fstWriterPackChain(xc, vm4ip, scratchpad);
+                        wrlen = scratchpad + xc->vchg_siz - scratchpnt;
+                        dmem = fstWriterPackCompress(xc, scratchpnt, wrlen, &packmem, &packmemlen, &dlen, &dhdr);
                         }
 
-                wrlen = scratchpad + xc->vchg_siz - scratchpnt;
                 unc_memreq += wrlen;
-                if(wrlen > 32)
-                        {
-                        unsigned long destlen = wrlen;
-                        unsigned char *dmem;
-                        unsigned int rc;
-
-                        if(!xc->fastpack)
-                                {
-                                if(wrlen <= packmemlen)
-                                        {
-                                        dmem = packmem;
-                                        }
-                                        else
-                                        {
-                                        free(packmem);
-                                        dmem = packmem = (unsigned char *)malloc(compressBound(packmemlen = wrlen));
-                                        }
-
-                                rc = compress2(dmem, &destlen, scratchpnt, wrlen, 4);
-                                if(rc == Z_OK)
-                                        {
-#ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                        PPvoid_t pv = JudyHSIns(&PJHSArray, dmem, destlen, NULL);
-                                        if(*pv)
-                                                {
-                                                uint32_t pvi = (intptr_t)(*pv);
-                                                vm4ip[2] = -pvi;
-                                                }
-                                                else
-                                                {
-                                                *pv = (void *)(intptr_t)(i+1);
-#endif
-                                                fpos += fstWriterVarint(f, wrlen);
-                                                fpos += destlen;
-                                                fstFwrite(dmem, destlen, 1, f);
-#ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                                }
-#endif
-                                        }
-                                        else
-                                        {
-#ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                        PPvoid_t pv = JudyHSIns(&PJHSArray, scratchpnt, wrlen, NULL);
-                                        if(*pv)
-                                                {
-                                                uint32_t pvi = (intptr_t)(*pv);
-                                                vm4ip[2] = -pvi;
-                                                }
-                                                else
-                                                {
-                                                *pv = (void *)(intptr_t)(i+1);
-#endif
-                                                fpos += fstWriterVarint(f, 0);
-                                                fpos += wrlen;
-                                                fstFwrite(scratchpnt, wrlen, 1, f);
-#ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                                }
-#endif
-                                        }
-                                }
-                                else
-                                {
-                                /* this is extremely conservative: fastlz needs +5% for worst case, lz4 needs siz+(siz/255)+16 */
-                                if(((wrlen * 2) + 2) <= packmemlen)
-                                        {
-                                        dmem = packmem;
-                                        }
-                                        else
-                                        {
-                                        free(packmem);
-                                        dmem = packmem = (unsigned char *)malloc(packmemlen = (wrlen * 2) + 2);
-                                        }
-
-                                rc = (xc->fourpack) ? LZ4_compress((char *)scratchpnt, (char *)dmem, wrlen) : fastlz_compress(scratchpnt, wrlen, dmem);
-                                if(rc < destlen)
-                                        {
-#ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                        PPvoid_t pv = JudyHSIns(&PJHSArray, dmem, rc, NULL);
-                                        if(*pv)
-                                                {
-                                                uint32_t pvi = (intptr_t)(*pv);
-                                                vm4ip[2] = -pvi;
-                                                }
-                                                else
-                                                {
-                                                *pv = (void *)(intptr_t)(i+1);
-#endif
-                                                fpos += fstWriterVarint(f, wrlen);
-                                                fpos += rc;
-                                                fstFwrite(dmem, rc, 1, f);
-#ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                                }
-#endif
-                                        }
-                                        else
-                                        {
-#ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                        PPvoid_t pv = JudyHSIns(&PJHSArray, scratchpnt, wrlen, NULL);
-                                        if(*pv)
-                                                {
-                                                uint32_t pvi = (intptr_t)(*pv);
-                                                vm4ip[2] = -pvi;
-                                                }
-                                                else
-                                                {
-                                                *pv = (void *)(intptr_t)(i+1);
-#endif
-                                                fpos += fstWriterVarint(f, 0);
-                                                fpos += wrlen;
-                                                fstFwrite(scratchpnt, wrlen, 1, f);
+                vm4ip[2] = fpos;
 #ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                                }
-#endif
-                                        }
-                                }
+                pv = JudyHSIns(&PJHSArray, dmem, dlen, NULL);
+                if(*pv)
+                        {
+                        uint32_t pvi = (intptr_t)(*pv);
+                        vm4ip[2] = -pvi;
                         }
                         else
                         {
-#ifndef FST_DYNAMIC_ALIAS_DISABLE
-                        PPvoid_t pv = JudyHSIns(&PJHSArray, scratchpnt, wrlen, NULL);
-                        if(*pv)
-                                {
-                                uint32_t pvi = (intptr_t)(*pv);
-                                vm4ip[2] = -pvi;
-                                }
-                                else
-                                {
-                                *pv = (void *)(intptr_t)(i+1);
+                        *pv = (void *)(intptr_t)(i+1);
 #endif
-                                fpos += fstWriterVarint(f, 0);
-                                fpos += wrlen;
-                                fstFwrite(scratchpnt, wrlen, 1, f);
+                        fpos += fstWriterVarint(f, dhdr);
+                        fpos += dlen;
+                        fstFwrite(dmem, dlen, 1, f);
 #ifndef FST_DYNAMIC_ALIAS_DISABLE
-                                }
-#endif
                         }
+#endif
 
                 /* vm4ip[3] = 0; ...redundant with clearing below */
 #ifdef FST_DEBUG
@@ -1621,6 +1754,12 @@ JudyHSFreeArray(&PJHSArray, NULL);
 #endif
 
 free(packmem); packmem = NULL; /* packmemlen = 0; */ /* scan-build */
+#ifdef FST_WRITER_PARALLEL
+if(packjob)
+        {
+        fstWriterPackFree(packjob); packjob = NULL;
+        }
+#endif
 
 prevpos = 0; zerocnt = 0;
 free(scratchpad); scratchpad = NULL;
@@ -2530,6 +2669,20 @@ if(xc)
 }
 
 
+/*
+ * with parallel mode, pack and compress each section's value changes
+ * using this many threads (default 1)
+ */
+void fstWriterSetParallelWorkers(void *ctx, int workers)
+{
+struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
+if(xc)
+        {
+        xc->parallel_workers = (workers > 1) ? workers : 1;
+        }
+}
+
+
 void fstWriterSetParallelMode(void *ctx, int enable)
 {
 struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
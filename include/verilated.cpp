@@ -1643,6 +1643,37 @@ IData VL_ATOI_N(const std::string& str, int base) VL_PURE {
 //===========================================================================
 // Dumping
 
+// clang-format off
+#define VL_BA_BIT_(b, n) static_cast<char>('0' + (((b) >> (n)) & 1))
+#define VL_BA_1_(b) { VL_BA_BIT_(b, 7), VL_BA_BIT_(b, 6), VL_BA_BIT_(b, 5), VL_BA_BIT_(b, 4), \
+                      VL_BA_BIT_(b, 3), VL_BA_BIT_(b, 2), VL_BA_BIT_(b, 1), VL_BA_BIT_(b, 0) }
+#define VL_BA_4_(b) VL_BA_1_(b), VL_BA_1_((b) + 1), VL_BA_1_((b) + 2), VL_BA_1_((b) + 3)
+#define VL_BA_16_(b) VL_BA_4_(b), VL_BA_4_((b) + 4), VL_BA_4_((b) + 8), VL_BA_4_((b) + 12)
+#define VL_BA_64_(b) VL_BA_16_(b), VL_BA_16_((b) + 16), VL_BA_16_((b) + 32), VL_BA_16_((b) + 48)
+const char VL_BYTE_ASCII[256][8] = {VL_BA_64_(0), VL_BA_64_(64), VL_BA_64_(128), VL_BA_64_(192)};
+#undef VL_BA_BIT_
+#undef VL_BA_1_
+#undef VL_BA_4_
+#undef VL_BA_16_
+#undef VL_BA_64_
+// clang-format on
+
+bool VL_WILDMATCH(const char* s, const char* p) VL_MT_SAFE {
+    for (; *p; s++, p++) {
+        if (*p != '*') {
+            if (((*s) != (*p)) && *p != '?') return false;
+        } else {
+            // Trailing star matches everything.
+            if (!*++p) return true;
+            while (!VL_WILDMATCH(s, p)) {
+                if (*++s == '\0') return false;
+            }
+            return true;
+        }
+    }
+    return (*s == '\0');
+}
+
 const char* vl_dumpctl_filenamep(bool setit, const std::string& filename) VL_MT_SAFE {
     // This function performs both accessing and setting so it's easy to make an in-function static
     static VL_THREAD_LOCAL std::string t_filename;
@@ -2076,6 +2107,7 @@ Verilated::ThreadLocal::ThreadLocal()
     :
 #ifdef VL_THREADED
     t_mtaskId(0)
+    , t_threadNum(0)
     , t_endOfEvalReqd(0)
     ,
 #endif
@@ -2553,6 +2585,7 @@ void VerilatedScope::varInsert(int finalize, const char* namep, void* datap,
     va_end(ap);
 
     m_varsp->insert(std::make_pair(namep, var));
+    VerilatedImp::scopeVarsChanged();
 }
 
 // cppcheck-suppress unusedFunction  // Used by applications
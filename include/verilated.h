@@ -422,6 +422,7 @@ class Verilated {
     static VL_THREAD_LOCAL struct ThreadLocal {
 #ifdef VL_THREADED
         vluint32_t t_mtaskId;  ///< Current mtask# executing on this thread
+        vluint32_t t_threadNum;  ///< Static thread number of mtask executing on this thread
         vluint32_t t_endOfEvalReqd;  ///< Messages may be pending, thread needs endOf-eval calls
 #endif
         const VerilatedScope* t_dpiScopep;  ///< DPI context scope
@@ -574,6 +575,9 @@ public:
     /// Set the mtaskId, called when an mtask starts
     static void mtaskId(vluint32_t id) VL_MT_SAFE { t_s.t_mtaskId = id; }
     static vluint32_t mtaskId() VL_MT_SAFE { return t_s.t_mtaskId; }
+    /// Set the static (pack_mtasks) thread number, called when an mtask starts
+    static void threadNum(vluint32_t num) VL_MT_SAFE { t_s.t_threadNum = num; }
+    static vluint32_t threadNum() VL_MT_SAFE { return t_s.t_threadNum; }
     static void endOfEvalReqdInc() VL_MT_SAFE { ++t_s.t_endOfEvalReqd; }
     static void endOfEvalReqdDec() VL_MT_SAFE { --t_s.t_endOfEvalReqd; }
 
@@ -665,6 +669,28 @@ inline QData VL_RDTSC_Q() {
 
 extern void VL_PRINTTIMESCALE(const char* namep, const char* timeunitp) VL_MT_SAFE;
 
+/// Return if string matches a glob pattern using * and ? wildcards
+extern bool VL_WILDMATCH(const char* s, const char* p) VL_MT_SAFE;
+
+/// Tracing: the 8 ASCII binary digits of each byte value, MSB first
+extern const char VL_BYTE_ASCII[256][8];
+
+/// Tracing: write the low bits of val as ASCII binary digits, MSB first,
+/// returning the new end of string (not NUL terminated)
+inline char* VL_BITS_ASCII(char* wp, vluint32_t val, int bits) VL_MT_SAFE {
+    // Any leading partial byte a bit at a time, then a byte per table lookup
+    for (int lead = bits & 7; lead; --lead) {
+        --bits;
+        *wp++ = static_cast<char>('0' | ((val >> bits) & 1));
+    }
+    while (bits) {
+        bits -= 8;
+        memcpy(wp, VL_BYTE_ASCII[(val >> bits) & 0xff], 8);
+        wp += 8;
+    }
+    return wp;
+}
+
 /// Math
 extern WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp,
                               bool is_modulus);
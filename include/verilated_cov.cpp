@@ -24,6 +24,7 @@
 #include <deque>
 #include <fstream>
 #include <map>
+#include <vector>
 
 //=============================================================================
 // VerilatedCovImpBase
@@ -81,6 +82,36 @@ public:
     virtual ~VerilatedCoverItemSpec() VL_OVERRIDE {}
 };
 
+//=============================================================================
+/// VerilatedCoverItemShards
+/// Coverage item counted in several shards, which are summed when read.
+
+template <class T> class VerilatedCoverItemShards : public VerilatedCovImpItem {
+private:
+    // MEMBERS
+    T* m_countp;  ///< Count value of first shard
+    int m_shards;  ///< Number of shards
+    size_t m_stride;  ///< Elements from one shard's count to the next
+public:
+    // METHODS
+    virtual vluint64_t count() const VL_OVERRIDE {
+        vluint64_t sum = 0;
+        for (int i = 0; i < m_shards; ++i) sum += m_countp[i * m_stride];
+        return sum;
+    }
+    virtual void zero() const VL_OVERRIDE {
+        for (int i = 0; i < m_shards; ++i) m_countp[i * m_stride] = 0;
+    }
+    // CONSTRUCTORS
+    VerilatedCoverItemShards(T* countp, int shards, size_t stride)
+        : m_countp(countp)
+        , m_shards(shards)
+        , m_stride(stride) {
+        zero();
+    }
+    virtual ~VerilatedCoverItemShards() VL_OVERRIDE {}
+};
+
 //=============================================================================
 // VerilatedCovImp
 /// Implementation class for VerilatedCov.  See that class for public method information.
@@ -155,16 +186,13 @@ private:
         if (key.length() == 2 && isdigit(key[1])) return false;
         return true;
     }
+    static std::string keyFormatter(const std::string& key) VL_PURE {
+        if (key.length() == 1 && isalpha(key[0])) return key;
+        return dequote(key);
+    }
     static std::string keyValueFormatter(const std::string& key,
                                          const std::string& value) VL_PURE {
-        std::string name;
-        if (key.length() == 1 && isalpha(key[0])) {
-            name += std::string("\001") + key;
-        } else {
-            name += std::string("\001") + dequote(key);
-        }
-        name += std::string("\002") + dequote(value);
-        return name;
+        return std::string("\001") + keyFormatter(key) + "\002" + dequote(value);
     }
     static std::string combineHier(const std::string& old, const std::string& add) VL_PURE {
         // (foo.a.x, foo.b.x) => foo.*.x
@@ -415,6 +443,173 @@ public:
             os << std::endl;
         }
     }
+
+private:
+    // Binary coverage file helpers
+    typedef std::map<std::string, vluint32_t> BinStringIds;
+    enum BinKeyKind { BIN_KEY_UNKNOWN = 0, BIN_KEY_OTHER, BIN_KEY_HIER, BIN_KEY_PER_INSTANCE };
+    static vluint32_t binStringId(BinStringIds& stringIds, std::vector<std::string>& strings,
+                                  const std::string& text) VL_PURE {
+        BinStringIds::iterator it = stringIds.find(text);
+        if (it != stringIds.end()) return it->second;
+        vluint32_t id = static_cast<vluint32_t>(strings.size());
+        stringIds.insert(std::make_pair(text, id));
+        strings.push_back(text);
+        return id;
+    }
+    static void binPut(std::string& buf, vluint64_t value) VL_PURE {
+        // Unsigned LEB128: 7 bits per byte, least significant first
+        while (value >= 0x80) {
+            buf += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        buf += static_cast<char>(value);
+    }
+    static void binFlush(std::ofstream& os, std::string& buf, size_t atLeast) {
+        if (buf.size() < atLeast) return;
+        os.write(buf.data(), buf.size());
+        buf.clear();
+    }
+
+public:
+    void writeBinary(const char* filename) VL_EXCLUDES(m_mutex) {
+        // Binary equivalent of write(), for designs with many points.
+        // Format, all numbers as unsigned LEB128 variable length integers:
+        //   VL_COV_BINARY_MAGIC
+        //   string count, then per string: length, characters
+        //   point count, then per point: count, pair count,
+        //       then per pair: key string number, value string number
+        // Keys and values are stored exactly as write() would print them,
+        // so a reader forms the text point name by joining each pair as
+        // "\001" key "\002" value.
+        // Points are grouped by their interned key/value indices, so unlike
+        // write() no per-point name strings need to be built or compared.
+        Verilated::quiesce();
+        VerilatedLockGuard lock(m_mutex);
+#ifndef VM_COVERAGE
+        VL_FATAL_MT("", 0, "",
+                    "%Error: Called VerilatedCov::writeBinary when VM_COVERAGE disabled\n");
+#endif
+        selftest();
+
+        std::ofstream os(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (os.fail()) {
+            std::string msg = std::string("%Error: Can't write '") + filename + "'";
+            VL_FATAL_MT("", 0, "", msg.c_str());
+            return;
+        }
+
+        // Interned index to value, and lazily to string table numbers
+        int maxIndex = m_indexValues.empty() ? 0 : m_indexValues.rbegin()->first;
+        std::vector<const std::string*> values(maxIndex + 1, NULL);
+        for (IndexValueMap::const_iterator it = m_indexValues.begin(); it != m_indexValues.end();
+             ++it) {
+            values[it->first] = &it->second;
+        }
+        const vluint32_t unset = ~static_cast<vluint32_t>(0);
+        std::vector<vluint32_t> keyIds(maxIndex + 1, unset);
+        std::vector<vluint32_t> valueIds(maxIndex + 1, unset);
+        std::vector<vluint8_t> keyKinds(maxIndex + 1, BIN_KEY_UNKNOWN);
+        ValueIndexMap::const_iterator zeroIt = m_valueIndexes.find("0");
+        int zeroIndex = (zeroIt != m_valueIndexes.end()) ? zeroIt->second : KEY_UNDEF;
+
+        BinStringIds stringIds;
+        std::vector<std::string> strings;
+        const vluint32_t hierKeyId
+            = binStringId(stringIds, strings, keyFormatter(VL_CIK_HIER));
+        const std::string emptyHier;
+
+        // Build list of events; totalize if collapsing hierarchy
+        typedef std::map<std::vector<vluint32_t>, std::pair<std::string, vluint64_t> > EventMap;
+        EventMap eventCounts;
+        std::vector<vluint32_t> pairs;
+        for (ItemList::iterator it = m_items.begin(); it != m_items.end(); ++it) {
+            VerilatedCovImpItem* itemp = *(it);
+            pairs.clear();
+            int hierIndex = KEY_UNDEF;
+            bool per_instance = false;
+
+            for (int i = 0; i < MAX_KEYS; ++i) {
+                int keyIndex = itemp->m_keys[i];
+                if (keyIndex == KEY_UNDEF) continue;
+                if (keyKinds[keyIndex] == BIN_KEY_UNKNOWN) {
+                    std::string key = VerilatedCovKey::shortKey(*values[keyIndex]);
+                    keyKinds[keyIndex] = (key == VL_CIK_HIER)
+                                             ? BIN_KEY_HIER
+                                             : (key == VL_CIK_PER_INSTANCE) ? BIN_KEY_PER_INSTANCE
+                                                                            : BIN_KEY_OTHER;
+                    keyIds[keyIndex] = binStringId(stringIds, strings, keyFormatter(key));
+                }
+                int valIndex = itemp->m_vals[i];
+                if (keyKinds[keyIndex] == BIN_KEY_PER_INSTANCE) {
+                    if (valIndex != zeroIndex) per_instance = true;
+                }
+                if (keyKinds[keyIndex] == BIN_KEY_HIER) {
+                    hierIndex = valIndex;
+                } else {
+                    if (valueIds[valIndex] == unset) {
+                        valueIds[valIndex]
+                            = binStringId(stringIds, strings, dequote(*values[valIndex]));
+                    }
+                    pairs.push_back(keyIds[keyIndex]);
+                    pairs.push_back(valueIds[valIndex]);
+                }
+            }
+            const std::string& hier = (hierIndex == KEY_UNDEF) ? emptyHier : *values[hierIndex];
+            if (per_instance) {  // Not collapsing hierarchies
+                pairs.push_back(hierKeyId);
+                pairs.push_back(binStringId(stringIds, strings, dequote(hier)));
+            }
+            const std::string& groupHier = per_instance ? emptyHier : hier;
+
+            // Find or insert the event
+            EventMap::iterator cit = eventCounts.find(pairs);
+            if (cit != eventCounts.end()) {
+                cit->second.second += itemp->count();
+                cit->second.first = combineHier(cit->second.first, groupHier);
+            } else {
+                eventCounts.insert(std::make_pair(pairs, make_pair(groupHier, itemp->count())));
+            }
+        }
+
+        // Combined hierarchies are only known now, so add them to the table
+        std::vector<vluint32_t> hierIds;
+        hierIds.reserve(eventCounts.size());
+        for (EventMap::const_iterator it = eventCounts.begin(); it != eventCounts.end(); ++it) {
+            hierIds.push_back(it->second.first.empty()
+                                  ? unset
+                                  : binStringId(stringIds, strings, dequote(it->second.first)));
+        }
+
+        // Output
+        const size_t flushSize = 64 * 1024;
+        std::string buf(VL_COV_BINARY_MAGIC);
+        binPut(buf, strings.size());
+        for (std::vector<std::string>::const_iterator it = strings.begin(); it != strings.end();
+             ++it) {
+            binPut(buf, it->size());
+            buf += *it;
+            binFlush(os, buf, flushSize);
+        }
+        binPut(buf, eventCounts.size());
+        std::vector<vluint32_t>::const_iterator hit = hierIds.begin();
+        for (EventMap::const_iterator it = eventCounts.begin(); it != eventCounts.end();
+             ++it, ++hit) {
+            const std::vector<vluint32_t>& itPairs = it->first;
+            binPut(buf, it->second.second);
+            binPut(buf, (itPairs.size() + (*hit == unset ? 0 : 2)) / 2);
+            for (std::vector<vluint32_t>::const_iterator pit = itPairs.begin();
+                 pit != itPairs.end(); ++pit) {
+                binPut(buf, *pit);
+            }
+            if (*hit != unset) {
+                binPut(buf, hierKeyId);
+                binPut(buf, *hit);
+            }
+            binFlush(os, buf, flushSize);
+        }
+        binFlush(os, buf, 0);
+    }
 };
 
 //=============================================================================
@@ -428,12 +623,18 @@ void VerilatedCov::zero() VL_MT_SAFE { VerilatedCovImp::imp().zero(); }
 void VerilatedCov::write(const char* filenamep) VL_MT_SAFE {
     VerilatedCovImp::imp().write(filenamep);
 }
+void VerilatedCov::writeBinary(const char* filenamep) VL_MT_SAFE {
+    VerilatedCovImp::imp().writeBinary(filenamep);
+}
 void VerilatedCov::_inserti(vluint32_t* itemp) VL_MT_SAFE {
     VerilatedCovImp::imp().inserti(new VerilatedCoverItemSpec<vluint32_t>(itemp));
 }
 void VerilatedCov::_inserti(vluint64_t* itemp) VL_MT_SAFE {
     VerilatedCovImp::imp().inserti(new VerilatedCoverItemSpec<vluint64_t>(itemp));
 }
+void VerilatedCov::_inserti(vluint32_t* itemp, int shards, size_t stride) VL_MT_SAFE {
+    VerilatedCovImp::imp().inserti(new VerilatedCoverItemShards<vluint32_t>(itemp, shards, stride));
+}
 void VerilatedCov::_insertf(const char* filename, int lineno) VL_MT_SAFE {
     VerilatedCovImp::imp().insertf(filename, lineno);
 }
@@ -72,6 +72,13 @@
     VL_IF_COVER(VerilatedCov::_inserti(countp); VerilatedCov::_insertf(__FILE__, __LINE__); \
                 VerilatedCov::_insertp("hier", name(), __VA_ARGS__))
 
+/// As VL_COVER_INSERT, for a point counted in several shards, e.g. one per
+/// thread; shard n's count is at countp[n * stride] and write() sums them.
+#define VL_COVER_INSERT_SHARDS(countp, shards, stride, ...) \
+    VL_IF_COVER(VerilatedCov::_inserti(countp, shards, stride); \
+                VerilatedCov::_insertf(__FILE__, __LINE__); \
+                VerilatedCov::_insertp("hier", name(), __VA_ARGS__))
+
 //=============================================================================
 /// Convert VL_COVER_INSERT value arguments to strings
 
@@ -97,6 +104,9 @@ public:
     static const char* defaultFilename() VL_PURE { return "coverage.dat"; }
     /// Write all coverage data to a file
     static void write(const char* filenamep = defaultFilename()) VL_MT_SAFE;
+    /// Write all coverage data to a file in the compact binary format;
+    /// faster than write() for large designs, and read by verilator_coverage
+    static void writeBinary(const char* filenamep = defaultFilename()) VL_MT_SAFE;
     /// Insert a coverage item
     /// We accept from 1-30 key/value pairs, all as strings.
     /// Call _insert1, followed by _insert2 and _insert3
@@ -104,6 +114,7 @@ public:
     // _insert1: Remember item pointer with count.  (Not const, as may add zeroing function)
     static void _inserti(vluint32_t* itemp) VL_MT_SAFE;
     static void _inserti(vluint64_t* itemp) VL_MT_SAFE;
+    static void _inserti(vluint32_t* itemp, int shards, size_t stride) VL_MT_SAFE;
     // _insert2: Set default filename and line number
     static void _insertf(const char* filename, int lineno) VL_MT_SAFE;
     // _insert3: Set parameters
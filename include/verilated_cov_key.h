@@ -95,6 +95,9 @@ VLCOVGEN_ITEM("name=>'weight',      short=>'w',  group=>0, default=>undef, descr
 #define VL_CIK_WEIGHT "w"
 // VLCOVGEN_CIK_AUTO_EDIT_END
 
+/// First line of a binary coverage file, see VerilatedCov::writeBinary
+#define VL_COV_BINARY_MAGIC "# SystemC::Coverage-3 binary\n"
+
 //=============================================================================
 // VerilatedCovKey
 /// Verilator coverage global class.
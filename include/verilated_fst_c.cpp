@@ -84,8 +84,13 @@ VerilatedFst::VerilatedFst(void* fst)
     , m_nextCode(1)
     , m_scopeEscape('.')
     , m_symbolp(NULL)
-    , m_sigs_oldvalp(NULL) {
-    m_valueStrBuffer.reserve(64 + 1);  // Need enough room for quad
+    , m_sigs_oldvalp(NULL)
+    , m_filtered(false)
+    , m_enabledCountsp(NULL)
+    , m_statDumps(0)
+    , m_statChecked(0)
+    , m_statChanged(0) {
+    m_valueStrBuffer.resize(64 + 1);  // Need enough room for quad
     set_time_unit(Verilated::timeunitString());
     set_time_resolution(Verilated::timeprecisionString());
 }
@@ -96,12 +101,15 @@ VerilatedFst::~VerilatedFst() {
     if (m_sigs_oldvalp) VL_DO_CLEAR(delete[] m_sigs_oldvalp, m_sigs_oldvalp = NULL);
 }
 
-void VerilatedFst::open(const char* filename) VL_MT_UNSAFE {
+void VerilatedFst::open(const char* filename, int workers) VL_MT_UNSAFE {
     m_assertOne.check();
     m_fst = fstWriterCreate(filename, 1);
     fstWriterSetPackType(m_fst, FST_WR_PT_LZ4);
 #ifdef VL_TRACE_THREADED
     fstWriterSetParallelMode(m_fst, 1);
+    fstWriterSetParallelWorkers(m_fst, workers);
+#else
+    if (workers) {}  // UNUSED - no writer thread
 #endif
     m_curScope.clear();
     m_nextCode = 1;
@@ -122,7 +130,7 @@ void VerilatedFst::open(const char* filename) VL_MT_UNSAFE {
 
     // convert m_code2symbol into an array for fast lookup
     if (!m_symbolp) {
-        m_symbolp = new fstHandle[m_nextCode + 10];
+        m_symbolp = new fstHandle[m_nextCode + 10]();  // Excluded codes have NULL handle
         for (Code2SymbolType::iterator it = m_code2symbol.begin(); it != m_code2symbol.end();
              ++it) {
             m_symbolp[it->first] = it->second;
@@ -132,10 +140,45 @@ void VerilatedFst::open(const char* filename) VL_MT_UNSAFE {
 
     // Allocate space now we know the number of codes
     if (!m_sigs_oldvalp) m_sigs_oldvalp = new vluint32_t[m_nextCode + 10];
+
+    if (m_filtered) {
+        // Convert enabled flags into counts, so isEnabledRange is two loads
+        m_enabledCounts.resize(m_nextCode + 1, 0);
+        vluint32_t count = 0;
+        for (vluint32_t code = 0; code <= m_nextCode; ++code) {
+            const vluint32_t enabled = m_enabledCounts[code];
+            m_enabledCounts[code] = count;
+            count += enabled;
+        }
+        m_enabledCountsp = &m_enabledCounts[0];
+    }
 }
 
 void VerilatedFst::module(const std::string& name) { m_module = name; }
 
+void VerilatedFst::traceInclude(const std::string& glob) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    m_filtered = true;
+    m_includes.push_back(glob);
+}
+
+void VerilatedFst::traceExclude(const std::string& glob) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    m_filtered = true;
+    m_excludes.push_back(glob);
+}
+
+static bool fstGlobsMatch(const std::vector<std::string>& globs, const std::string& name) {
+    // Return if name, or a scope containing it, matches any pattern
+    for (std::vector<std::string>::const_iterator it = globs.begin(); it != globs.end(); ++it) {
+        for (size_t pos = name.find('.'); true; pos = name.find('.', pos + 1)) {
+            if (VL_WILDMATCH(name.substr(0, pos).c_str(), it->c_str())) return true;
+            if (pos == std::string::npos) break;
+        }
+    }
+    return false;
+}
+
 //=============================================================================
 // Decl
 
@@ -155,9 +198,9 @@ void VerilatedFst::declSymbol(vluint32_t code, const char* name, int dtypenum, f
     int codesNeeded = 1 + int(bits / 32);
     // Not supported: if (tri) codesNeeded *= 2;  // Space in change array for __en signals
     m_nextCode = std::max(m_nextCode, code + codesNeeded);
+    // Need enough room for ASCII value of widest array
+    if (m_valueStrBuffer.size() < bits + 32) m_valueStrBuffer.resize(bits + 32);
 
-    std::pair<Code2SymbolType::iterator, bool> p
-        = m_code2symbol.insert(std::make_pair(code, static_cast<fstHandle>(NULL)));
     std::istringstream nameiss(name);
     std::istream_iterator<std::string> beg(nameiss), end;
     std::list<std::string> tokens(beg, end);  // Split name
@@ -165,6 +208,32 @@ void VerilatedFst::declSymbol(vluint32_t code, const char* name, int dtypenum, f
     tokens.pop_back();  // Remove symbol name from hierarchy
     tokens.insert(tokens.begin(), m_module);  // Add current module to the hierarchy
 
+    if (m_filtered) {
+        std::string dotted;
+        for (std::list<std::string>::const_iterator it = tokens.begin(); it != tokens.end();
+             ++it) {
+            if (it->empty()) continue;
+            dotted += *it + ".";
+        }
+        dotted += symbol_name;
+        if (array) {
+            std::stringstream arr_ss;
+            arr_ss << "(" << arraynum << ")";
+            dotted += arr_ss.str();
+        }
+        const bool enabled = (m_includes.empty() || fstGlobsMatch(m_includes, dotted))
+                             && !fstGlobsMatch(m_excludes, dotted);
+        // No symbol, so full* discard changes, and no var or scope in header
+        if (!enabled) return;
+        if (m_enabledCounts.size() < code + codesNeeded) {
+            m_enabledCounts.resize(code + codesNeeded, 0);
+        }
+        for (int i = 0; i < codesNeeded; ++i) m_enabledCounts[code + i] = 1;
+    }
+
+    std::pair<Code2SymbolType::iterator, bool> p
+        = m_code2symbol.insert(std::make_pair(code, static_cast<fstHandle>(NULL)));
+
     // Find point where current and new scope diverge
     std::list<std::string>::iterator cur_it = m_curScope.begin();
     std::list<std::string>::iterator new_it = tokens.begin();
@@ -239,6 +308,7 @@ void VerilatedFst::dump(vluint64_t timeui) {
         return;
     }
     fstWriterEmitTimeChange(m_fst, timeui);
+    ++m_statDumps;
     for (vluint32_t ent = 0; ent < m_callbacks.size(); ++ent) {
         VerilatedFstCallInfo* cip = m_callbacks[ent];
         (cip->m_changecb)(this, cip->m_userthis, cip->m_code);
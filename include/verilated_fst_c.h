@@ -58,6 +58,15 @@ private:
     std::list<std::string> m_curScope;
     fstHandle* m_symbolp;  ///< same as m_code2symbol, but as an array
     vluint32_t* m_sigs_oldvalp;
+    bool m_filtered;  ///< traceInclude/traceExclude were called
+    std::vector<std::string> m_includes;  ///< Glob patterns of signals to trace
+    std::vector<std::string> m_excludes;  ///< Glob patterns of signals to not trace
+    /// Count of enabled codes before each code, or while declaring, if code enabled
+    std::vector<vluint32_t> m_enabledCounts;
+    const vluint32_t* m_enabledCountsp;  ///< Pointer to first element of above
+    vluint64_t m_statDumps;  ///< Number of change dumps, see statDumps()
+    vluint64_t m_statChecked;  ///< Number of signals checked, see statChecked()
+    vluint64_t m_statChanged;  ///< Number of signals changed, see statChanged()
     // CONSTRUCTORS
     VL_UNCOPYABLE(VerilatedFst);
     void declSymbol(vluint32_t code, const char* name, int dtypenum, fstVarDir vardir,
@@ -70,7 +79,13 @@ public:
     ~VerilatedFst();
     void changeThread() { m_assertOne.changeThread(); }
     bool isOpen() const { return m_fst != NULL; }
-    void open(const char* filename) VL_MT_UNSAFE;
+    /// Number of change dumps made, excluding full dumps
+    vluint64_t statDumps() const { return m_statDumps; }
+    /// Number of signals checked for changes over all change dumps
+    vluint64_t statChecked() const { return m_statChecked; }
+    /// Number of signals found changed over all change dumps
+    vluint64_t statChanged() const { return m_statChanged; }
+    void open(const char* filename, int workers = 1) VL_MT_UNSAFE;
     void flush() VL_MT_UNSAFE { fstWriterFlushContext(m_fst); }
     void close() VL_MT_UNSAFE {
         m_assertOne.check();
@@ -90,6 +105,11 @@ public:
     void scopeEscape(char flag) { m_scopeEscape = flag; }
     /// Is this an escape?
     bool isScopeEscape(char c) { return isspace(c) || c == m_scopeEscape; }
+    /// Before open(), trace only signals matching the given glob pattern
+    /// (and any other traceInclude patterns)
+    void traceInclude(const std::string& glob) VL_MT_UNSAFE_ONE;
+    /// Before open(), do not trace signals matching the given glob pattern
+    void traceExclude(const std::string& glob) VL_MT_UNSAFE_ONE;
     /// Inside dumping routines, called each cycle to make the dump
     void dump(vluint64_t timeui);
     /// Inside dumping routines, declare callbacks for tracings
@@ -134,35 +154,74 @@ public:
     // Inside dumping routines used by Verilator
 
     vluint32_t* oldp(vluint32_t code) { return m_sigs_oldvalp + code; }
+    /// Return if any code from code to endCode-1 is being traced
+    bool isEnabledRange(vluint32_t code, vluint32_t endCode) const {
+        return !m_filtered || m_enabledCountsp[endCode] != m_enabledCountsp[code];
+    }
+    /// Count signals about to be checked for changes, see statChecked().
+    /// Only counted with VL_TRACE_STATS, from --trace-fine-activity.
+    void statCheckedInc(vluint32_t count) {
+#ifdef VL_TRACE_STATS
+        m_statChecked += count;
+#endif
+    }
+    /// Count a signal found changed, see statChanged()
+    inline void statChangedInc() {
+#ifdef VL_TRACE_STATS
+        ++m_statChanged;
+#endif
+    }
 
     //=========================================================================
     // Write back to previous value buffer value and emit
+    // (signals removed by traceExclude/traceInclude have a NULL symbol)
+    // Values are converted to the ASCII fstWriterEmitValueChange takes here,
+    // using the byte table, rather than bit by bit in fstapi.
 
     void fullBit(vluint32_t* oldp, vluint32_t newval) {
         *oldp = newval;
-        fstWriterEmitValueChange(m_fst, m_symbolp[oldp - m_sigs_oldvalp], newval ? "1" : "0");
+        const fstHandle symbol = m_symbolp[oldp - m_sigs_oldvalp];
+        if (VL_LIKELY(symbol)) fstWriterEmitValueChange(m_fst, symbol, &"01"[newval & 1]);
     }
     template <int T_Bits> void fullBus(vluint32_t* oldp, vluint32_t newval) {
         *oldp = newval;
-        fstWriterEmitValueChange32(m_fst, m_symbolp[oldp - m_sigs_oldvalp], T_Bits, newval);
+        const fstHandle symbol = m_symbolp[oldp - m_sigs_oldvalp];
+        if (VL_UNLIKELY(!symbol)) return;
+        char buf[32];
+        VL_BITS_ASCII(buf, newval, T_Bits);
+        fstWriterEmitValueChange(m_fst, symbol, buf);
     }
     void fullQuad(vluint32_t* oldp, vluint64_t newval, int bits) {
         *reinterpret_cast<vluint64_t*>(oldp) = newval;
-        fstWriterEmitValueChange64(m_fst, m_symbolp[oldp - m_sigs_oldvalp], bits, newval);
+        const fstHandle symbol = m_symbolp[oldp - m_sigs_oldvalp];
+        if (VL_UNLIKELY(!symbol)) return;
+        char buf[64];
+        char* wp = VL_BITS_ASCII(buf, static_cast<vluint32_t>(newval >> 32), bits - 32);
+        VL_BITS_ASCII(wp, static_cast<vluint32_t>(newval), 32);
+        fstWriterEmitValueChange(m_fst, symbol, buf);
     }
     void fullArray(vluint32_t* oldp, const vluint32_t* newvalp, int bits) {
         for (int i = 0; i < (bits + 31) / 32; ++i) oldp[i] = newvalp[i];
-        fstWriterEmitValueChangeVec32(m_fst, m_symbolp[oldp - m_sigs_oldvalp], bits, newvalp);
+        const fstHandle symbol = m_symbolp[oldp - m_sigs_oldvalp];
+        if (VL_UNLIKELY(!symbol)) return;
+        // m_valueStrBuffer was sized for the widest signal by declSymbol
+        int words = (bits + 31) / 32;
+        const int bitsInMSW = bits % 32 == 0 ? 32 : bits % 32;
+        char* wp = VL_BITS_ASCII(&m_valueStrBuffer[0], newvalp[--words], bitsInMSW);
+        while (words > 0) wp = VL_BITS_ASCII(wp, newvalp[--words], 32);
+        fstWriterEmitValueChange(m_fst, symbol, &m_valueStrBuffer[0]);
     }
     void fullFloat(vluint32_t* oldp, float newval) {
         // cppcheck-suppress invalidPointerCast
         *reinterpret_cast<float*>(oldp) = newval;
-        fstWriterEmitValueChange(m_fst, m_symbolp[oldp - m_sigs_oldvalp], oldp);
+        const fstHandle symbol = m_symbolp[oldp - m_sigs_oldvalp];
+        if (VL_LIKELY(symbol)) fstWriterEmitValueChange(m_fst, symbol, oldp);
     }
     void fullDouble(vluint32_t* oldp, double newval) {
         // cppcheck-suppress invalidPointerCast
         *reinterpret_cast<double*>(oldp) = newval;
-        fstWriterEmitValueChange(m_fst, m_symbolp[oldp - m_sigs_oldvalp], oldp);
+        const fstHandle symbol = m_symbolp[oldp - m_sigs_oldvalp];
+        if (VL_LIKELY(symbol)) fstWriterEmitValueChange(m_fst, symbol, oldp);
     }
 
     //=========================================================================
@@ -170,31 +229,47 @@ public:
 
     inline void chgBit(vluint32_t* oldp, vluint32_t newval) {
         const vluint32_t diff = *oldp ^ newval;
-        if (VL_UNLIKELY(diff)) fullBit(oldp, newval);
+        if (VL_UNLIKELY(diff)) {
+            statChangedInc();
+            fullBit(oldp, newval);
+        }
     }
     template <int T_Bits> inline void chgBus(vluint32_t* oldp, vluint32_t newval) {
         const vluint32_t diff = *oldp ^ newval;
-        if (VL_UNLIKELY(diff)) fullBus<T_Bits>(oldp, newval);
+        if (VL_UNLIKELY(diff)) {
+            statChangedInc();
+            fullBus<T_Bits>(oldp, newval);
+        }
     }
     inline void chgQuad(vluint32_t* oldp, vluint64_t newval, int bits) {
         const vluint64_t diff = *reinterpret_cast<vluint64_t*>(oldp) ^ newval;
-        if (VL_UNLIKELY(diff)) fullQuad(oldp, newval, bits);
+        if (VL_UNLIKELY(diff)) {
+            statChangedInc();
+            fullQuad(oldp, newval, bits);
+        }
     }
     inline void chgArray(vluint32_t* oldp, const vluint32_t* newvalp, int bits) {
-        for (int i = 0; i < (bits + 31) / 32; ++i) {
-            if (VL_UNLIKELY(oldp[i] ^ newvalp[i])) {
-                fullArray(oldp, newvalp, bits);
-                return;
-            }
+        // Accumulate differences without branching, so the loop may vectorize
+        vluint32_t diff = 0;
+        for (int i = 0; i < (bits + 31) / 32; ++i) diff |= oldp[i] ^ newvalp[i];
+        if (VL_UNLIKELY(diff)) {
+            statChangedInc();
+            fullArray(oldp, newvalp, bits);
         }
     }
     inline void chgFloat(vluint32_t* oldp, float newval) {
         // cppcheck-suppress invalidPointerCast
-        if (VL_UNLIKELY(*reinterpret_cast<float*>(oldp) != newval)) fullFloat(oldp, newval);
+        if (VL_UNLIKELY(*reinterpret_cast<float*>(oldp) != newval)) {
+            statChangedInc();
+            fullFloat(oldp, newval);
+        }
     }
     inline void chgDouble(vluint32_t* oldp, double newval) {
         // cppcheck-suppress invalidPointerCast
-        if (VL_UNLIKELY(*reinterpret_cast<double*>(oldp) != newval)) fullDouble(oldp, newval);
+        if (VL_UNLIKELY(*reinterpret_cast<double*>(oldp) != newval)) {
+            statChangedInc();
+            fullDouble(oldp, newval);
+        }
     }
 };
 
@@ -221,8 +296,30 @@ public:
     /// Is file open?
     bool isOpen() const { return m_sptrace.isOpen(); }
     // METHODS
-    /// Open a new FST file
-    void open(const char* filename) VL_MT_UNSAFE_ONE { m_sptrace.open(filename); }
+    /// Open a new FST file.
+    /// With --trace-fst-thread, workers is the number of threads which
+    /// compress each block of value changes; the file is the same for any
+    /// number of workers.  Otherwise workers is ignored.
+    void open(const char* filename, int workers = 1) VL_MT_UNSAFE_ONE {
+        m_sptrace.open(filename, workers);
+    }
+    /// Before open(), trace only signals matching the given glob pattern
+    /// (and any other traceInclude patterns), e.g. "top.t.u_core.*".
+    /// A pattern matching a scope includes all signals under that scope.
+    void traceInclude(const std::string& glob) { m_sptrace.traceInclude(glob); }
+    /// Before open(), do not trace signals matching the given glob pattern,
+    /// or under a scope matching it.  Exclusions take precedence.
+    void traceExclude(const std::string& glob) { m_sptrace.traceExclude(glob); }
+    /// Number of change dumps made, excluding full dumps.  With
+    /// statChecked() and statChanged() this gives the average number of
+    /// signals checked, and found changed, per dump.
+    vluint64_t statDumps() const { return m_sptrace.statDumps(); }
+    /// Number of signals checked for changes over all change dumps.
+    /// This and statChanged() are only counted when the model was
+    /// Verilated with --trace-fine-activity, and are otherwise zero.
+    vluint64_t statChecked() const { return m_sptrace.statChecked(); }
+    /// Number of signals found changed over all change dumps
+    vluint64_t statChanged() const { return m_sptrace.statChanged(); }
     /// Close dump
     void close() VL_MT_UNSAFE_ONE { m_sptrace.close(); }
     /// Flush dump
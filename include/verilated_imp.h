@@ -211,9 +211,11 @@ protected:
     VerilatedMutex m_userMapMutex;  ///< Protect m_userMap
     UserMap m_userMap VL_GUARDED_BY(m_userMapMutex);  ///< Map of <(scope,userkey), userData>
 
-    VerilatedMutex m_nameMutex;  ///< Protect m_nameMap
+    VerilatedMutex m_nameMutex;  ///< Protect m_nameMap, m_nameGeneration
     /// Map of <scope_name, scope pointer>
     VerilatedScopeNameMap m_nameMap VL_GUARDED_BY(m_nameMutex);
+    /// Incremented when a scope or scope variable is added or removed
+    vluint64_t m_nameGeneration VL_GUARDED_BY(m_nameMutex);
 
     VerilatedMutex m_hierMapMutex;  ///< Protect m_hierMap
     /// Map the represents scope hierarchy
@@ -235,6 +237,7 @@ public:  // But only for verilated*.cpp
     // CONSTRUCTORS
     VerilatedImp()
         : m_argVecLoaded(false)
+        , m_nameGeneration(0)
         , m_exportNext(0) {
         m_fdps.resize(3);
         m_fdps[0] = stdin;
@@ -335,6 +338,7 @@ public:  // But only for verilated*.cpp
         if (it == s_s.m_nameMap.end()) {
             s_s.m_nameMap.insert(it, std::make_pair(scopep->name(), scopep));
         }
+        ++s_s.m_nameGeneration;
     }
     static inline const VerilatedScope* scopeFind(const char* namep) VL_MT_SAFE {
         VerilatedLockGuard lock(s_s.m_nameMutex);
@@ -349,6 +353,18 @@ public:  // But only for verilated*.cpp
         userEraseScope(scopep);
         VerilatedScopeNameMap::iterator it = s_s.m_nameMap.find(scopep->name());
         if (it != s_s.m_nameMap.end()) s_s.m_nameMap.erase(it);
+        ++s_s.m_nameGeneration;
+    }
+    static void scopeVarsChanged() VL_MT_SAFE {
+        // Slow ok - called once/variable at construction
+        VerilatedLockGuard lock(s_s.m_nameMutex);
+        ++s_s.m_nameGeneration;
+    }
+    static vluint64_t scopeGeneration() VL_MT_SAFE {
+        // Changes when scopes or their variables change, so callers caching
+        // lookups, e.g. vpi_handle_by_name, know to rebuild
+        VerilatedLockGuard lock(s_s.m_nameMutex);
+        return s_s.m_nameGeneration;
     }
     static void scopesDump() VL_MT_SAFE {
         VerilatedLockGuard lock(s_s.m_nameMutex);
@@ -20,15 +20,31 @@
 #include "verilated.h"
 #include "verilated_save.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <cstdio>
+#include <ctime>
 #include <fcntl.h>
 
 // clang-format off
 #if defined(_WIN32) && !defined(__MINGW32__) && !defined(__CYGWIN__)
+# include <direct.h>
 # include <io.h>
+# define getcwd _getcwd
 #else
 # include <unistd.h>
 #endif
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# define VL_SAVE_FORK 1  // Have fork(), so VerilatedSaveAsync saves in background
+# include <sys/time.h>
+# include <sys/types.h>
+# include <sys/wait.h>
+#endif
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# define VL_SAVE_MMAP 1  // Have mmap(), so VerilatedRestore maps files
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
 
 #ifndef O_LARGEFILE  // For example on WIN32
 # define O_LARGEFILE 0
@@ -45,6 +61,8 @@
 static const char* const VLTSAVE_HEADER_STR
     = "verilatorsave01\n";  ///< Value of first bytes of each file
 static const char* const VLTSAVE_TRAILER_STR = "vltsaved";  ///< Value of last bytes of each file
+static const char* const VLTSAVE_DELTA_STR
+    = "verilatordelta1\n";  ///< Value of first bytes of each delta file
 
 //=============================================================================
 //=============================================================================
@@ -113,6 +131,85 @@ void VerilatedDeserialize::trailer() VL_MT_UNSAFE_ONE {
     }
 }
 
+//=============================================================================
+// Delta checkpoint utilities
+
+static vluint64_t vlSaveHash(const vluint8_t* datap, size_t size) {
+    // Not cryptographic, only needs to tell a changed block from the base's.
+    // Each step is a bijection of the state, so a block differing from the
+    // base in a single word always hashes differently.
+    vluint64_t hash = VL_ULL(0x9e3779b97f4a7c15) ^ size;
+    const size_t words = size / sizeof(vluint64_t);
+    for (size_t i = 0; i < words; ++i) {
+        vluint64_t word;
+        memcpy(&word, datap + i * sizeof(vluint64_t), sizeof(vluint64_t));
+        hash = (hash ^ word) * VL_ULL(0xff51afd7ed558ccd);
+        hash ^= hash >> 32;
+    }
+    for (size_t i = words * sizeof(vluint64_t); i < size; ++i) {
+        hash = (hash ^ datap[i]) * VL_ULL(0x100000001b3);
+    }
+    return hash;
+}
+
+static vluint64_t vlSaveHashOfHashes(const std::vector<vluint64_t>& hashes) {
+    // Identifies a base checkpoint, from the hash of each of its blocks
+    if (hashes.empty()) return 0;
+    return vlSaveHash(reinterpret_cast<const vluint8_t*>(&hashes[0]),
+                      hashes.size() * sizeof(vluint64_t));
+}
+
+static std::string vlSaveAbsolute(const std::string& filename) {
+    // Absolute path, so a delta finds its base from any working directory
+    if (filename.empty() || filename[0] == '/' || filename[0] == '\\') return filename;
+    if (filename.size() > 1 && filename[1] == ':') return filename;  // Windows drive
+    char cwd[4096];
+    if (!getcwd(cwd, sizeof(cwd))) return filename;
+    return std::string(cwd) + "/" + filename;
+}
+
+static std::string vlSaveDirname(const std::string& filename) {
+    // Directory part of filename, with trailing separator, or empty
+    const size_t pos = filename.find_last_of("/\\");
+    return pos == std::string::npos ? "" : filename.substr(0, pos + 1);
+}
+
+static ssize_t vlSaveReadFd(int fd, void* datap, size_t size) {
+    // Read until size bytes, EOF, or error; returns bytes read or -1
+    vluint8_t* dp = static_cast<vluint8_t*>(datap);
+    size_t done = 0;
+    while (done < size) {
+        errno = 0;
+        ssize_t got = ::read(fd, dp + done, size - done);
+        if (got > 0) {
+            done += got;
+        } else if (got == 0) {
+            break;
+        } else if (errno != EAGAIN && errno != EINTR) {
+            return -1;
+        }
+    }
+    return static_cast<ssize_t>(done);
+}
+
+static bool vlSaveBaseMatches(int fd, vluint64_t blockSize, vluint64_t length,
+                              vluint64_t hash) {
+    // Hash the base as VerilatedSaveDelta::block did while writing it, and
+    // return if it is unchanged; leaves fd at the start of the file
+    if (blockSize == 0 || blockSize > (VL_ULL(1) << 30)) return false;
+    std::vector<vluint8_t> buf(blockSize);
+    std::vector<vluint64_t> hashes;
+    for (vluint64_t left = length; left;) {
+        const size_t size = static_cast<size_t>(std::min(left, blockSize));
+        if (vlSaveReadFd(fd, &buf[0], size) != static_cast<ssize_t>(size)) return false;
+        hashes.push_back(vlSaveHash(&buf[0], size));
+        left -= size;
+    }
+    if (vlSaveReadFd(fd, &buf[0], 1) != 0) return false;  // Base is longer
+    if (::lseek(fd, 0, SEEK_SET) != 0) return false;
+    return vlSaveHashOfHashes(hashes) == hash;
+}
+
 //=============================================================================
 //=============================================================================
 //=============================================================================
@@ -161,9 +258,103 @@ void VerilatedRestore::open(const char* filenamep) VL_MT_UNSAFE_ONE {
     m_filename = filenamep;
     m_cp = m_bufp;
     m_endp = m_bufp;
+    if (!openDelta()) return;
+    if (m_baseFd < 0) openMap();
+    header();
+}
+
+void VerilatedRestore::openMap() VL_MT_UNSAFE_ONE {
+#ifdef VL_SAVE_MMAP
+    // Restore straight from the mapped file, rather than copying it through
+    // m_bufp; fill() then only needs to handle the tail of the file
+    struct stat st;
+    if (fstat(m_fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) return;
+    size_t size = static_cast<size_t>(st.st_size);
+    if (static_cast<off_t>(size) != st.st_size) return;  // Too large for address space
+    void* mapp = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (mapp == MAP_FAILED) return;  // Fall back to read()
+# ifdef MADV_SEQUENTIAL
+    ::madvise(mapp, size, MADV_SEQUENTIAL);
+# endif
+    m_mapp = static_cast<vluint8_t*>(mapp);
+    m_mapSize = size;
+    m_cp = m_mapp;
+    m_endp = m_mapp + m_mapSize;
+#endif
+}
+
+void VerilatedRestoreMem::open(const vluint8_t* datap, size_t size) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (isOpen()) return;
+    m_isOpen = true;
+    m_filename = "<memory>";
+    // Only read through m_cp, the data is never written
+    m_cp = const_cast<vluint8_t*>(datap);
+    m_endp = m_cp + size;
+    header();
+}
+
+void VerilatedSaveMem::open() VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (isOpen()) return;
+    m_isOpen = true;
+    m_filename = "<memory>";
+    m_data.clear();
+    m_cp = m_bufp;
     header();
 }
 
+bool VerilatedRestore::openDelta() VL_MT_UNSAFE_ONE {
+    // A delta file has its own signature, then names the base checkpoint
+    // it was made against; anything else is read as a normal save file
+    m_baseFd = -1;
+    m_offset = 0;
+    m_copyLeft = 0;
+    m_literalLeft = 0;
+    const size_t sigLen = strlen(VLTSAVE_DELTA_STR);
+    char sig[16];
+    assert(sigLen == sizeof(sig));
+    if (vlSaveReadFd(m_fd, sig, sigLen) != static_cast<ssize_t>(sigLen)
+        || 0 != memcmp(sig, VLTSAVE_DELTA_STR, sigLen)) {
+        ::lseek(m_fd, 0, SEEK_SET);
+        return true;
+    }
+    // Header is block size, base length, base hash, then base filename
+    vluint64_t baseInfo[3] = {0, 0, 0};
+    vluint32_t nameLen = 0;
+    std::string basename;
+    if (vlSaveReadFd(m_fd, baseInfo, sizeof(baseInfo)) == sizeof(baseInfo)
+        && vlSaveReadFd(m_fd, &nameLen, sizeof(nameLen)) == sizeof(nameLen)) {
+        basename.resize(nameLen);
+        if (vlSaveReadFd(m_fd, &basename[0], nameLen) == static_cast<ssize_t>(nameLen)) {
+            m_baseFd = ::open(basename.c_str(), O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+            if (m_baseFd < 0) {
+                // Both moved together, look beside the delta file
+                const size_t pos = basename.find_last_of("/\\");
+                std::string moved = vlSaveDirname(filename())
+                                    + (pos == std::string::npos ? basename
+                                                                : basename.substr(pos + 1));
+                m_baseFd = ::open(moved.c_str(), O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+                if (m_baseFd >= 0) basename = moved;
+            }
+        }
+    }
+    std::string msg;
+    if (m_baseFd < 0) {
+        msg = "Can't open base checkpoint '" + basename + "' for delta file: " + filename();
+    } else if (!vlSaveBaseMatches(m_baseFd, baseInfo[0], baseInfo[1], baseInfo[2])) {
+        msg = "Can't deserialize; base checkpoint '" + basename
+              + "' has changed since delta file was made: " + filename();
+    }
+    if (VL_UNLIKELY(!msg.empty())) {
+        std::string fn = filename();
+        VL_FATAL_MT(fn.c_str(), 0, "", msg.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
 void VerilatedSave::close() VL_MT_UNSAFE_ONE {
     if (!isOpen()) return;
     trailer();
@@ -172,12 +363,90 @@ void VerilatedSave::close() VL_MT_UNSAFE_ONE {
     ::close(m_fd);  // May get error, just ignore it
 }
 
+void VerilatedSaveDelta::open(const char* filenamep) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (isOpen()) return;
+    VL_DEBUG_IF(VL_DBG_MSGF("- save: opening delta save file %s\n", filenamep););
+
+    // cppcheck-suppress duplicateExpression
+    m_fd = ::open(filenamep, O_CREAT | O_WRONLY | O_TRUNC | O_LARGEFILE | O_NONBLOCK | O_CLOEXEC,
+                  0666);
+    if (m_fd < 0) {
+        // User code can check isOpen()
+        m_isOpen = false;
+        return;
+    }
+    m_isOpen = true;
+    m_filename = filenamep;
+    m_cp = m_bufp;
+    m_block.clear();
+    m_out.clear();
+    m_offset = 0;
+    m_copyBytes = 0;
+    // Rewriting the base itself must make a new base, as the old one is gone
+    m_writingBase = m_baseFilename.empty() || m_baseFilename == vlSaveAbsolute(m_filename);
+    if (m_writingBase) {
+        m_baseFilename = "";
+        m_baseHashes.clear();
+    } else {
+        out(VLTSAVE_DELTA_STR, strlen(VLTSAVE_DELTA_STR));
+        const vluint64_t baseInfo[3] = {m_blockSize, m_baseLength, m_baseHash};
+        out(baseInfo, sizeof(baseInfo));
+        vluint32_t nameLen = m_baseFilename.length();
+        out(&nameLen, sizeof(nameLen));
+        out(m_baseFilename.data(), nameLen);
+    }
+    header();
+}
+
+void VerilatedSaveDelta::close() VL_MT_UNSAFE_ONE {
+    if (!isOpen()) return;
+    trailer();
+    flush();
+    if (!m_block.empty()) block(&m_block[0], m_block.size());
+    m_block.clear();
+    if (m_copyBytes) {
+        vluint64_t rec[2] = {m_copyBytes, 0};
+        out(rec, sizeof(rec));
+    }
+    outFlush();
+    if (!isOpen()) return;  // Write error
+    m_isOpen = false;
+    ::close(m_fd);  // May get error, just ignore it
+    if (m_writingBase) {
+        m_baseFilename = vlSaveAbsolute(m_filename);
+        m_baseLength = m_offset;
+        m_baseHash = vlSaveHashOfHashes(m_baseHashes);
+    }
+}
+
 void VerilatedRestore::close() VL_MT_UNSAFE_ONE {
     if (!isOpen()) return;
     trailer();
     flush();
     m_isOpen = false;
     ::close(m_fd);  // May get error, just ignore it
+    if (m_baseFd >= 0) ::close(m_baseFd);
+    m_baseFd = -1;
+#ifdef VL_SAVE_MMAP
+    if (m_mapp) ::munmap(m_mapp, m_mapSize);
+#endif
+    m_mapp = NULL;
+    m_cp = m_endp = m_bufp;
+}
+
+void VerilatedSaveMem::close() VL_MT_UNSAFE_ONE {
+    if (!isOpen()) return;
+    trailer();
+    flush();
+    m_isOpen = false;
+}
+
+void VerilatedRestoreMem::close() VL_MT_UNSAFE_ONE {
+    if (!isOpen()) return;
+    trailer();
+    m_isOpen = false;
+    m_cp = m_endp = m_bufp;  // Drop pointers into caller's data
 }
 
 //=============================================================================
@@ -207,9 +476,138 @@ void VerilatedSave::flush() VL_MT_UNSAFE_ONE {
     m_cp = m_bufp;  // Reset buffer
 }
 
+void VerilatedSaveDelta::flush() VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (VL_UNLIKELY(!isOpen())) return;
+    // Cut the stream into blocks at fixed offsets, whatever the buffer held
+    const vluint8_t* dp = m_bufp;
+    const vluint8_t* const endp = m_cp;
+    if (!m_block.empty()) {
+        size_t take = m_blockSize - m_block.size();
+        if (take > static_cast<size_t>(endp - dp)) take = endp - dp;
+        m_block.insert(m_block.end(), dp, dp + take);
+        dp += take;
+        if (m_block.size() == m_blockSize) {
+            block(&m_block[0], m_blockSize);
+            m_block.clear();
+        }
+    }
+    for (; static_cast<size_t>(endp - dp) >= m_blockSize; dp += m_blockSize) {
+        block(dp, m_blockSize);
+    }
+    m_block.insert(m_block.end(), dp, endp);
+    m_cp = m_bufp;  // Reset buffer
+    outFlush();
+}
+
+void VerilatedSaveDelta::block(const vluint8_t* datap, size_t size) VL_MT_UNSAFE_ONE {
+    vluint64_t hash = vlSaveHash(datap, size);
+    if (m_writingBase) {
+        m_baseHashes.push_back(hash);
+        out(datap, size);
+    } else {
+        size_t index = m_offset / m_blockSize;
+        if (m_offset + size <= m_baseLength && index < m_baseHashes.size()
+            && m_baseHashes[index] == hash) {
+            m_copyBytes += size;  // Unchanged, restore will read it from base
+        } else {
+            // Record is bytes to copy from base, then bytes that follow here
+            vluint64_t rec[2] = {m_copyBytes, size};
+            out(rec, sizeof(rec));
+            out(datap, size);
+            m_copyBytes = 0;
+        }
+    }
+    m_offset += size;
+}
+
+void VerilatedSaveDelta::out(const void* datap, size_t size) VL_MT_UNSAFE_ONE {
+    const vluint8_t* dp = static_cast<const vluint8_t*>(datap);
+    m_out.insert(m_out.end(), dp, dp + size);
+    if (m_out.size() >= bufferSize()) outFlush();
+}
+
+void VerilatedSaveDelta::outFlush() VL_MT_UNSAFE_ONE {
+    if (VL_UNLIKELY(!isOpen())) return;
+    size_t done = 0;
+    while (done < m_out.size()) {
+        errno = 0;
+        ssize_t got = ::write(m_fd, &m_out[done], m_out.size() - done);
+        if (got > 0) {
+            done += got;
+        } else if (got < 0) {
+            if (errno != EAGAIN && errno != EINTR) {
+                // write failed, presume error (perhaps out of disk space)
+                std::string msg = std::string(__FUNCTION__) + ": " + strerror(errno);
+                VL_FATAL_MT("", 0, "", msg.c_str());
+                m_isOpen = false;
+                ::close(m_fd);
+                break;
+            }
+        }
+    }
+    m_out.clear();
+}
+
+ssize_t VerilatedRestore::readStream(vluint8_t* datap, size_t size) VL_MT_UNSAFE_ONE {
+    if (m_baseFd < 0) return ::read(m_fd, datap, size);
+    // Delta file; rebuild the stream from the records and the base
+    while (true) {
+        if (m_copyLeft) {
+            if (size > m_copyLeft) size = m_copyLeft;
+            ssize_t got = ::read(m_baseFd, datap, size);
+            if (got > 0) {
+                m_copyLeft -= got;
+                m_offset += got;
+            } else if (got == 0) {  // Base checked to be long enough on open
+                errno = EIO;
+                return -1;
+            }
+            return got;
+        }
+        if (m_literalLeft) {
+            if (size > m_literalLeft) size = m_literalLeft;
+            ssize_t got = ::read(m_fd, datap, size);
+            if (got > 0) {
+                m_literalLeft -= got;
+                m_offset += got;
+            }
+            return got;
+        }
+        vluint64_t rec[2];
+        ssize_t got = vlSaveReadFd(m_fd, rec, sizeof(rec));
+        if (got != static_cast<ssize_t>(sizeof(rec))) return got < 0 ? got : 0;  // EOF
+        m_copyLeft = rec[0];
+        m_literalLeft = rec[1];
+        if (m_copyLeft && ::lseek(m_baseFd, m_offset, SEEK_SET) < 0) return -1;
+    }
+}
+
+void VerilatedSaveMem::flush() VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (VL_UNLIKELY(!isOpen())) return;
+    m_data.insert(m_data.end(), m_bufp, m_cp);
+    m_cp = m_bufp;  // Reset buffer
+}
+
+void VerilatedDeserialize::fillTail() VL_MT_UNSAFE_ONE {
+    // All data is already in memory, so only reached near its end.  Move what
+    // is left to the start of m_bufp and pad with NULLs, so readers don't
+    // need to check eof each character.  (memmove, may already be in m_bufp)
+    size_t remaining = m_endp - m_cp;
+    if (remaining) memmove(m_bufp, m_cp, remaining);
+    m_cp = m_bufp;
+    m_endp = m_bufp + remaining;
+    while (m_endp < m_bufp + bufferSize()) *m_endp++ = '\0';
+}
+
 void VerilatedRestore::fill() VL_MT_UNSAFE_ONE {
     m_assertOne.check();
     if (VL_UNLIKELY(!isOpen())) return;
+    if (m_mapp) {
+        fillTail();
+        return;
+    }
     // Move remaining characters down to start of buffer.  (No memcpy, overlaps allowed)
     vluint8_t* rp = m_bufp;
     for (vluint8_t* sp = m_cp; sp < m_endp; *rp++ = *sp++) {}  // Overlaps
@@ -220,7 +618,7 @@ void VerilatedRestore::fill() VL_MT_UNSAFE_ONE {
         ssize_t remaining = (m_bufp + bufferSize() - m_endp);
         if (remaining == 0) break;
         errno = 0;
-        ssize_t got = ::read(m_fd, m_endp, remaining);
+        ssize_t got = readStream(m_endp, remaining);
         if (got > 0) {
             m_endp += got;
         } else if (got < 0) {
@@ -240,5 +638,102 @@ void VerilatedRestore::fill() VL_MT_UNSAFE_ONE {
     }
 }
 
+//=============================================================================
+// Background saving
+
+static double vlSaveAsyncSecs() {
+#ifdef VL_SAVE_FORK
+    struct timeval tv;
+    if (gettimeofday(&tv, NULL) < 0) return 0;
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1e-6;
+#else
+    return static_cast<double>(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+static bool vlSaveAsyncWrite(const char* filenamep, VerilatedSaveAsync::SaveCb_t cb,
+                             void* userp) VL_MT_UNSAFE_ONE {
+    // Write under a temporary name, so a save which dies part way through
+    // can't replace an earlier good file
+    std::string tmpname = std::string(filenamep) + ".tmp";
+    {
+        VerilatedSave os;
+        os.open(tmpname);
+        if (!os.isOpen()) return false;
+        cb(os, userp);
+        os.close();
+    }
+#ifndef VL_SAVE_FORK
+    ::remove(filenamep);  // Windows rename won't replace an existing file
+#endif
+    return ::rename(tmpname.c_str(), filenamep) == 0;
+}
+
+bool VerilatedSaveAsync::save(const char* filenamep, SaveCb_t cb, void* userp) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    VL_DEBUG_IF(VL_DBG_MSGF("- save: background save to %s\n", filenamep););
+    Pending job;
+    job.m_pid = 0;
+    job.m_filename = filenamep;
+    job.m_startSecs = vlSaveAsyncSecs();
+#ifdef VL_SAVE_FORK
+    // The child inherits unwritten stdio buffers; flush so nothing prints twice
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Child; _exit so the parent's atexit handlers and destructors don't run
+        _exit(vlSaveAsyncWrite(filenamep, cb, userp) ? 0 : 1);
+    }
+    job.m_stallSecs = m_lastStallSecs = vlSaveAsyncSecs() - job.m_startSecs;
+    if (VL_UNLIKELY(pid < 0)) {
+        VL_DEBUG_IF(VL_DBG_MSGF("- save: fork failed: %s\n", strerror(errno)););
+        return false;
+    }
+    job.m_pid = pid;
+    m_pending.push_back(job);
+    return true;
+#else
+    bool ok = vlSaveAsyncWrite(filenamep, cb, userp);
+    job.m_stallSecs = m_lastStallSecs = vlSaveAsyncSecs() - job.m_startSecs;
+    done(job, ok);
+    return ok;
+#endif
+}
+
+void VerilatedSaveAsync::reap(bool block) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+#ifdef VL_SAVE_FORK
+    // Collect first, as a done callback may start another save()
+    PendingVec finished;
+    std::vector<bool> finishedOk;
+    for (PendingVec::iterator it = m_pending.begin(); it != m_pending.end();) {
+        int status = 0;
+        pid_t got = ::waitpid(it->m_pid, &status, block ? 0 : WNOHANG);
+        if (got == 0) {  // Still writing
+            ++it;
+            continue;
+        }
+        if (got < 0 && errno == EINTR) continue;  // Retry
+        finished.push_back(*it);
+        finishedOk.push_back(got > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        it = m_pending.erase(it);
+    }
+    for (size_t i = 0; i < finished.size(); ++i) done(finished[i], finishedOk[i]);
+#else
+    if (block) {}  // UNUSED - saves completed inside save()
+#endif
+}
+
+void VerilatedSaveAsync::done(const Pending& job, bool ok) VL_MT_UNSAFE_ONE {
+    double totalSecs = vlSaveAsyncSecs() - job.m_startSecs;
+    VL_DEBUG_IF(VL_DBG_MSGF("- save: %s %s, stalled %g s, total %g s\n",
+                            job.m_filename.c_str(), ok ? "saved" : "FAILED",
+                            job.m_stallSecs, totalSecs););
+    if (m_doneCb) {
+        m_doneCb(job.m_filename.c_str(), ok, job.m_stallSecs, totalSecs, m_doneUserp);
+    }
+}
+
 //=============================================================================
 // Serialization of types
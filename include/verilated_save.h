@@ -23,6 +23,7 @@
 #include "verilated_heavy.h"
 
 #include <string>
+#include <vector>
 
 //=============================================================================
 // VerilatedSerialize - convert structures to a stream representation
@@ -68,8 +69,9 @@ public:
             bufferCheck();
             size_t blk = size;
             if (blk > bufferInsertSize()) blk = bufferInsertSize();
-            const vluint8_t* __restrict maxp = dp + blk;
-            for (; dp < maxp; *m_cp++ = *dp++) {}
+            memcpy(m_cp, dp, blk);
+            m_cp += blk;
+            dp += blk;
             size -= blk;
         }
         return *this;  // For function chaining
@@ -103,6 +105,7 @@ protected:
     inline static size_t bufferInsertSize() { return 16 * 1024; }
 
     virtual void fill() = 0;
+    void fillTail() VL_MT_UNSAFE_ONE;
     void header() VL_MT_UNSAFE_ONE;
     void trailer() VL_MT_UNSAFE_ONE;
 
@@ -131,8 +134,9 @@ public:
             bufferCheck();
             size_t blk = size;
             if (blk > bufferInsertSize()) blk = bufferInsertSize();
-            const vluint8_t* __restrict maxp = dp + blk;
-            for (; dp < maxp; *dp++ = *m_cp++) {}
+            memcpy(dp, m_cp, blk);
+            m_cp += blk;
+            dp += blk;
             size -= blk;
         }
         return *this;  // For function chaining
@@ -174,18 +178,162 @@ public:
     virtual void flush() VL_OVERRIDE VL_MT_UNSAFE_ONE;
 };
 
+//=============================================================================
+// VerilatedSaveDelta - serialize to a file, storing only changes from a base
+// The first open() after construction or rebase() writes a full checkpoint,
+// readable as a normal VerilatedSave file, and remembers a hash of each
+// block of it.  Later open()s write a delta file, holding only the blocks
+// which differ from that base, plus the base's absolute filename and a
+// hash of its contents.  VerilatedRestore reads either kind of file; a
+// delta requires its unchanged base file, either at its original path or
+// in the delta file's directory.
+// This class is not thread safe, it must be called by a single thread
+
+class VerilatedSaveDelta : public VerilatedSerialize {
+private:
+    // MEMBERS
+    int m_fd;  ///< File descriptor we're writing to
+    size_t m_blockSize;  ///< Bytes of stream per compared block
+    bool m_writingBase;  ///< Writing a full checkpoint, recording hashes
+    std::string m_baseFilename;  ///< Base checkpoint, empty if must write one
+    vluint64_t m_baseLength;  ///< Stream bytes in base checkpoint
+    vluint64_t m_baseHash;  ///< Hash of m_baseHashes, identifying the base
+    std::vector<vluint64_t> m_baseHashes;  ///< Hash of each block of base
+    std::vector<vluint8_t> m_block;  ///< Partial block carried between flushes
+    std::vector<vluint8_t> m_out;  ///< Pending bytes for m_fd
+    vluint64_t m_offset;  ///< Stream bytes processed so far
+    vluint64_t m_copyBytes;  ///< Bytes matching base since last literal block
+
+    // METHODS
+    void block(const vluint8_t* datap, size_t size) VL_MT_UNSAFE_ONE;
+    void out(const void* datap, size_t size) VL_MT_UNSAFE_ONE;
+    void outFlush() VL_MT_UNSAFE_ONE;
+
+public:
+    // CONSTRUCTORS
+    explicit VerilatedSaveDelta(size_t blockSize = 4096)
+        : m_fd(-1)
+        , m_blockSize(blockSize)
+        , m_writingBase(true)
+        , m_baseLength(0)
+        , m_baseHash(0)
+        , m_offset(0)
+        , m_copyBytes(0) {}
+    virtual ~VerilatedSaveDelta() VL_OVERRIDE { close(); }
+    // METHODS
+    /// Open the file; call isOpen() to see if errors
+    void open(const char* filenamep) VL_MT_UNSAFE_ONE;
+    void open(const std::string& filename) VL_MT_UNSAFE_ONE { open(filename.c_str()); }
+    virtual void close() VL_OVERRIDE VL_MT_UNSAFE_ONE;
+    virtual void flush() VL_OVERRIDE VL_MT_UNSAFE_ONE;
+    /// Make the next open() write a full checkpoint, and use it as the new base
+    void rebase() VL_MT_UNSAFE_ONE { m_baseFilename = ""; }
+    /// Absolute filename of the base checkpoint deltas refer to, empty if none yet
+    std::string baseFilename() const { return m_baseFilename; }
+    /// Return if the file being written is a full (base) checkpoint
+    bool writingBase() const { return m_writingBase; }
+};
+
+//=============================================================================
+// VerilatedSaveAsync - serialize to a file from a background process
+// save() forks the process; the child has a copy-on-write snapshot of the
+// model as of the call, which it serializes and writes while the parent
+// continues simulating.  Completion is reported from poll() or wait().
+// Platforms without fork() save synchronously inside save().
+// This class is not thread safe, it must be called by the eval thread,
+// between evaluations of the model
+
+class VerilatedSaveAsync {
+public:
+    // TYPES
+    /// Serializes the model, e.g. "os << main_time; os << *topp;".
+    /// Called in the child process, so must not change state the parent needs.
+    typedef void (*SaveCb_t)(VerilatedSave& os, void* userp);
+    /// Called by poll() or wait() when a save finishes.
+    /// stallSecs is how long save() held up simulation; totalSecs is from
+    /// save() until the file was complete, as far as poll() could tell.
+    typedef void (*DoneCb_t)(const char* filenamep, bool ok, double stallSecs, double totalSecs,
+                             void* userp);
+
+private:
+    struct Pending {
+        int m_pid;  ///< Process writing the file
+        std::string m_filename;  ///< File being written
+        double m_startSecs;  ///< Time save() was called
+        double m_stallSecs;  ///< Time save() blocked the caller
+    };
+    typedef std::vector<Pending> PendingVec;
+
+    // MEMBERS
+    PendingVec m_pending;  ///< Saves not yet reported as done
+    DoneCb_t m_doneCb;  ///< Completion callback
+    void* m_doneUserp;  ///< User data for completion callback
+    double m_lastStallSecs;  ///< Stall of the most recent save()
+    VerilatedAssertOneThread m_assertOne;  ///< Assert only called from single thread
+
+    // CONSTRUCTORS
+    VL_UNCOPYABLE(VerilatedSaveAsync);
+
+    // METHODS
+    void reap(bool block) VL_MT_UNSAFE_ONE;
+    void done(const Pending& job, bool ok) VL_MT_UNSAFE_ONE;
+
+public:
+    VerilatedSaveAsync()
+        : m_doneCb(NULL)
+        , m_doneUserp(NULL)
+        , m_lastStallSecs(0) {}
+    ~VerilatedSaveAsync() { wait(); }
+    // METHODS
+    /// Set function to call when each save finishes
+    void doneCb(DoneCb_t cb, void* userp) VL_MT_UNSAFE_ONE {
+        m_doneCb = cb;
+        m_doneUserp = userp;
+    }
+    /// Start saving to the given file by calling cb; returns false if the
+    /// save could not be started (or on synchronous platforms, failed)
+    bool save(const char* filenamep, SaveCb_t cb, void* userp) VL_MT_UNSAFE_ONE;
+    bool save(const std::string& filename, SaveCb_t cb, void* userp) VL_MT_UNSAFE_ONE {
+        return save(filename.c_str(), cb, userp);
+    }
+    /// Report any finished saves, without blocking
+    void poll() VL_MT_UNSAFE_ONE { reap(false); }
+    /// Block until all saves have finished, reporting each
+    void wait() VL_MT_UNSAFE_ONE { reap(true); }
+    /// Number of saves started but not yet reported
+    size_t pending() const { return m_pending.size(); }
+    /// Seconds the most recent save() stalled simulation
+    double lastStallSecs() const { return m_lastStallSecs; }
+};
+
 //=============================================================================
 // VerilatedRestore - deserialize from a file
 // This class is not thread safe, it must be called by a single thread
 
 class VerilatedRestore : public VerilatedDeserialize {
 private:
-    int m_fd;  ///< File descriptor we're writing to
+    int m_fd;  ///< File descriptor we're reading from
+    vluint8_t* m_mapp;  ///< File mapped into memory, else NULL
+    size_t m_mapSize;  ///< Bytes mapped at m_mapp
+    int m_baseFd;  ///< Base checkpoint when reading a delta file, else -1
+    vluint64_t m_offset;  ///< Delta: stream bytes read so far
+    vluint64_t m_copyLeft;  ///< Delta: bytes of current record to take from base
+    vluint64_t m_literalLeft;  ///< Delta: bytes of current record to take from delta
+
+    bool openDelta() VL_MT_UNSAFE_ONE;
+    void openMap() VL_MT_UNSAFE_ONE;
+    ssize_t readStream(vluint8_t* datap, size_t size) VL_MT_UNSAFE_ONE;
 
 public:
     // CONSTRUCTORS
     VerilatedRestore()
-        : m_fd(-1) {}
+        : m_fd(-1)
+        , m_mapp(NULL)
+        , m_mapSize(0)
+        , m_baseFd(-1)
+        , m_offset(0)
+        , m_copyLeft(0)
+        , m_literalLeft(0) {}
     virtual ~VerilatedRestore() VL_OVERRIDE { close(); }
 
     // METHODS
@@ -197,6 +345,52 @@ public:
     virtual void fill() VL_OVERRIDE VL_MT_UNSAFE_ONE;
 };
 
+//=============================================================================
+// VerilatedSaveMem - serialize to memory
+// Holds the same data as a VerilatedSave file, for example to clone a model
+// by restoring the snapshot into other instances with VerilatedRestoreMem.
+// This class is not thread safe, it must be called by a single thread
+
+class VerilatedSaveMem : public VerilatedSerialize {
+private:
+    std::vector<vluint8_t> m_data;  ///< Serialized data
+
+public:
+    // CONSTRUCTORS
+    VerilatedSaveMem() {}
+    virtual ~VerilatedSaveMem() VL_OVERRIDE { close(); }
+    // METHODS
+    /// Discard any previous snapshot and start a new one
+    void open() VL_MT_UNSAFE_ONE;
+    virtual void close() VL_OVERRIDE VL_MT_UNSAFE_ONE;
+    virtual void flush() VL_OVERRIDE VL_MT_UNSAFE_ONE;
+    /// Snapshot data, valid once closed
+    const vluint8_t* datap() const { return m_data.empty() ? NULL : &m_data[0]; }
+    size_t size() const { return m_data.size(); }
+};
+
+//=============================================================================
+// VerilatedRestoreMem - deserialize from memory
+// Reads directly from the caller's data, which must not change or be freed
+// until close().
+// This class is not thread safe, it must be called by a single thread
+
+class VerilatedRestoreMem : public VerilatedDeserialize {
+public:
+    // CONSTRUCTORS
+    VerilatedRestoreMem() {}
+    virtual ~VerilatedRestoreMem() VL_OVERRIDE { close(); }
+    // METHODS
+    /// Open a snapshot made by VerilatedSaveMem, or the contents of a save file
+    void open(const vluint8_t* datap, size_t size) VL_MT_UNSAFE_ONE;
+    void open(const VerilatedSaveMem& snapshot) VL_MT_UNSAFE_ONE {
+        open(snapshot.datap(), snapshot.size());
+    }
+    virtual void close() VL_OVERRIDE VL_MT_UNSAFE_ONE;
+    virtual void flush() VL_OVERRIDE VL_MT_UNSAFE_ONE {}
+    virtual void fill() VL_OVERRIDE VL_MT_UNSAFE_ONE { fillTail(); }
+};
+
 //=============================================================================
 
 inline VerilatedSerialize& operator<<(VerilatedSerialize& os, vluint64_t& rhs) {
@@ -23,12 +23,25 @@
 #include "verilated.h"
 #include "verilated_vcd_c.h"
 
+#ifdef VL_TRACE_GZ
+# include <zlib.h>
+#endif
+
 #include <algorithm>
 #include <cerrno>
 #include <ctime>
 #include <fcntl.h>
 #include <sys/stat.h>
 
+#ifdef VL_THREADED
+# include "verilated_threads.h"
+#endif
+#ifdef VL_TRACE_THREADED
+# include <condition_variable>
+# include <mutex>
+# include <thread>
+#endif
+
 #if defined(_WIN32) && !defined(__MINGW32__) && !defined(__CYGWIN__)
 # include <io.h>
 #else
@@ -128,6 +141,133 @@ protected:
     ~VerilatedVcdCallInfo() {}
 };
 
+//=============================================================================
+// vcdWriteAll
+/// Write an entire buffer, retrying short writes; return 0 or errno on failure.
+
+static int vcdWriteAll(VerilatedVcdFile* filep, const char* bufp, ssize_t len) VL_MT_UNSAFE {
+    const char* wp = bufp;
+    while (true) {
+        ssize_t remaining = (bufp + len - wp);
+        if (remaining == 0) break;
+        errno = 0;
+        ssize_t got = filep->write(wp, remaining);
+        if (got > 0) {
+            wp += got;
+        } else if (got < 0) {
+            // write failed, presume error (perhaps out of disk space)
+            if (errno != EAGAIN && errno != EINTR) return errno;
+        }
+    }
+    return 0;
+}
+
+#ifdef VL_TRACE_THREADED
+//=============================================================================
+// VerilatedVcdWorker
+/// Background thread writing a full output buffer, while the simulation
+/// thread continues filling the other buffer.
+/// This is an internally used class
+
+class VerilatedVcdWorker {
+    VerilatedVcdFile* m_filep;  ///< File to write to
+    std::mutex m_mutex;  ///< Protect below
+    std::condition_variable m_cond;  ///< Signal change of m_bufp or m_shutdown
+    const char* m_bufp;  ///< Buffer being written, NULL when idle
+    ssize_t m_len;  ///< Length of m_bufp
+    int m_errno;  ///< Error from failed write, not yet reported
+    bool m_shutdown;  ///< Exit thread once idle
+    std::thread m_thread;  ///< Writer thread, last so constructed after above
+
+    VL_UNCOPYABLE(VerilatedVcdWorker);
+
+public:
+    explicit VerilatedVcdWorker(VerilatedVcdFile* filep)
+        : m_filep(filep)
+        , m_bufp(NULL)
+        , m_len(0)
+        , m_errno(0)
+        , m_shutdown(false)
+        , m_thread(&VerilatedVcdWorker::main, this) {}
+    ~VerilatedVcdWorker() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+    /// Wait for the previous buffer to be written; return 0 or errno on failure
+    int wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_bufp) m_cond.wait(lock);
+        int errnum = m_errno;
+        m_errno = 0;
+        return errnum;
+    }
+    /// Start writing a buffer, which must not change until wait() returns
+    void write(const char* bufp, ssize_t len) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bufp = bufp;
+            m_len = len;
+        }
+        m_cond.notify_all();
+    }
+
+private:
+    void main() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            while (!m_bufp && !m_shutdown) m_cond.wait(lock);
+            if (!m_bufp) return;  // Shutdown, and nothing left to write
+            const char* bufp = m_bufp;
+            ssize_t len = m_len;
+            lock.unlock();
+            int errnum = vcdWriteAll(m_filep, bufp, len);
+            lock.lock();
+            if (errnum) m_errno = errnum;
+            m_bufp = NULL;
+            m_cond.notify_all();
+        }
+    }
+};
+#endif  // VL_TRACE_THREADED
+
+#ifdef VL_THREADED
+//=============================================================================
+// VerilatedVcdShards
+/// Buffers, and the state passed to the thread pool, for
+/// VerilatedVcd::chgParallel.
+/// This is an internally used class
+
+class VerilatedVcdShards {
+public:
+    struct Chunk {
+        VerilatedVcd* m_vcdp;  ///< Shard buffer to trace into
+        VerilatedVcdCallback_t m_cb;  ///< Change callback to call
+        void* m_userthis;  ///< Callback user data
+        vluint32_t m_code;  ///< Callback base code
+        std::atomic<int>* m_pendingp;  ///< Decremented when chunk is done
+    };
+    std::vector<Chunk> m_chunks;  ///< Chunk for each shard, chunk 0 not included
+    std::atomic<int> m_pending;  ///< Chunks not yet complete
+
+    VerilatedVcdShards()
+        : m_pending(0) {}
+    ~VerilatedVcdShards() {
+        for (std::vector<Chunk>::iterator it = m_chunks.begin(); it != m_chunks.end(); ++it) {
+            VL_DO_DANGLING(delete it->m_vcdp, it->m_vcdp);
+        }
+    }
+    static void runChunk(bool, VlThrSymTab chunkp) {
+        Chunk* cp = static_cast<Chunk*>(chunkp);
+        (cp->m_cb)(cp->m_vcdp, cp->m_userthis, cp->m_code);
+        cp->m_pendingp->fetch_sub(1, std::memory_order_release);
+    }
+};
+#endif  // VL_THREADED
+
 //=============================================================================
 //=============================================================================
 //=============================================================================
@@ -145,6 +285,64 @@ ssize_t VerilatedVcdFile::write(const char* bufp, ssize_t len) VL_MT_UNSAFE {
     return ::write(m_fd, bufp, len);
 }
 
+//=============================================================================
+// VerilatedVcdGzFile
+
+static bool vcdIsGzName(const std::string& name) {
+    return name.size() > 3 && 0 == name.compare(name.size() - 3, 3, ".gz");
+}
+
+// Return if name is for a raw trace file, see VL_TRACE_RAW_MAGIC
+static bool vcdIsBinaryName(const std::string& name) {
+    return name.size() > 4 && 0 == name.compare(name.size() - 4, 4, ".vtr");
+}
+
+#ifdef VL_TRACE_GZ
+bool VerilatedVcdGzFile::open(const std::string& name) VL_MT_UNSAFE {
+    if (!vcdIsGzName(name)) return VerilatedVcdFile::open(name);
+    char mode[10];
+    VL_SNPRINTF(mode, sizeof(mode), "wb%d", m_level);
+    gzFile gzp = gzopen(name.c_str(), mode);
+    if (!gzp) return false;
+    gzbuffer(gzp, 256 * 1024);  // Before any write
+    m_gzp = gzp;
+    return true;
+}
+
+void VerilatedVcdGzFile::close() VL_MT_UNSAFE {
+    if (!m_gzp) return VerilatedVcdFile::close();
+    gzclose(static_cast<gzFile>(m_gzp));
+    m_gzp = NULL;
+}
+
+ssize_t VerilatedVcdGzFile::write(const char* bufp, ssize_t len) VL_MT_UNSAFE {
+    if (!m_gzp) return VerilatedVcdFile::write(bufp, len);
+    // gzwrite takes an unsigned length, so limit each call
+    const unsigned piece = static_cast<unsigned>(std::min<ssize_t>(len, 1024 * 1024 * 1024));
+    const int got = gzwrite(static_cast<gzFile>(m_gzp), bufp, piece);
+    if (got <= 0) {
+        int errnum = 0;
+        gzerror(static_cast<gzFile>(m_gzp), &errnum);
+        if (errnum != Z_ERRNO) errno = EIO;  // Else errno already set
+        return -1;
+    }
+    return got;
+}
+#else
+bool VerilatedVcdGzFile::open(const std::string& name) VL_MT_UNSAFE {
+    if (vcdIsGzName(name)) {
+        VL_PRINTF_MT("%%Warning: VerilatedVcd: Compressed output requires VL_TRACE_GZ "
+                     "(--trace-gz), writing uncompressed %s\n",
+                     name.c_str());
+    }
+    return VerilatedVcdFile::open(name);
+}
+void VerilatedVcdGzFile::close() VL_MT_UNSAFE { VerilatedVcdFile::close(); }
+ssize_t VerilatedVcdGzFile::write(const char* bufp, ssize_t len) VL_MT_UNSAFE {
+    return VerilatedVcdFile::write(bufp, len);
+}
+#endif  // VL_TRACE_GZ
+
 //=============================================================================
 //=============================================================================
 //=============================================================================
@@ -157,18 +355,36 @@ VerilatedVcd::VerilatedVcd(VerilatedVcdFile* filep)
     , m_nextCode(1) {
     // Not in header to avoid link issue if header is included without this .cpp file
     m_fileNewed = (filep == NULL);
+#ifdef VL_TRACE_GZ
+    m_filep = m_fileNewed ? new VerilatedVcdGzFile : filep;
+#else
     m_filep = m_fileNewed ? new VerilatedVcdFile : filep;
+#endif
     m_namemapp = NULL;
     m_timeLastDump = 0;
     m_sigs_oldvalp = NULL;
+    m_filtered = false;
+    m_enabledCountsp = NULL;
     m_evcd = false;
+    m_binary = false;
+    m_binaryHeading = false;
     m_scopeEscape = '.';  // Backward compatibility
     m_fullDump = true;
     m_wrChunkSize = 8 * 1024;
     m_wrBufp = new char[m_wrChunkSize * 8];
+    m_wrSparep = NULL;
     m_wrFlushp = m_wrBufp + m_wrChunkSize * 6;
     m_writep = m_wrBufp;
     m_wroteBytes = 0;
+    m_workerp = NULL;
+    m_shardsp = NULL;
+    m_isShard = false;
+    m_statDumps = 0;
+    m_statChecked = 0;
+    m_statChanged = 0;
+    m_flightSegBytes = 0;
+    m_flightSegs = 0;
+    m_flightDirty = false;
     m_suffixesp = NULL;
     m_timeRes = m_timeUnit = 1e-9;
     set_time_unit(Verilated::timeunitString());
@@ -178,6 +394,15 @@ VerilatedVcd::VerilatedVcd(VerilatedVcdFile* filep)
 void VerilatedVcd::open(const char* filename) {
     m_assertOne.check();
     if (isOpen()) return;
+#ifndef VL_TRACE_VCD_OLD_API
+    const std::string name = filename;
+    if (VL_UNLIKELY(vcdIsGzName(name) && vcdIsBinaryName(name.substr(0, name.size() - 3)))) {
+        // verilator_trace_conv maps the file, so can't read it compressed
+        std::string msg = "Raw trace files can't be compressed, open without .gz: " + name;
+        VL_FATAL_MT("", 0, "", msg.c_str());
+        return;
+    }
+#endif
 
     // Set member variables
     m_filename = filename;  // "" is ok, as someone may overload open
@@ -187,15 +412,56 @@ void VerilatedVcd::open(const char* filename) {
     // Set callback so an early exit will flush us
     Verilated::flushCb(&flush_all);
 
+#ifdef VL_TRACE_THREADED
+    // Full buffers are written by a separate thread
+    if (!m_flightSegs) {
+        m_wrSparep = new char[m_wrChunkSize * 8];
+        m_workerp = new VerilatedVcdWorker(m_filep);
+    }
+#endif
+
     // SPDIFF_ON
+#ifndef VL_TRACE_VCD_OLD_API
+    m_binary = vcdIsBinaryName(m_filename);
+#endif
+    if (m_flightSegs) m_rolloverMB = 0;  // Only one file is written
     openNext(m_rolloverMB != 0);
     if (!isOpen()) return;
 
-    dumpHeader();
+    if (m_binary) {
+        // Keep the header, as every rollover file needs it to be converted
+        m_binaryHeading = true;
+        printStr(VL_TRACE_RAW_MAGIC);
+        dumpHeader();
+        bufferFlush();
+        m_binaryHeading = false;
+        // Records are aligned, so the file can be read through a mapping
+        m_binaryHeader.resize((m_binaryHeader.size() + 3) & ~static_cast<size_t>(3), '\0');
+        bufferAppend(m_binaryHeader.data(), m_binaryHeader.size());
+    } else {
+        dumpHeader();
+    }
+    if (m_flightSegs) {
+        // Keep the header separately, it's needed for every flightDump
+        bufferFlush();
+        m_flightRing.push_back(std::string());
+    }
 
     // Allocate space now we know the number of codes
     if (!m_sigs_oldvalp) m_sigs_oldvalp = new vluint32_t[m_nextCode + 10];
 
+    if (m_filtered) {
+        // Convert enabled flags into counts, so isEnabledRange is two loads
+        m_enabledCounts.resize(m_nextCode + 1, 0);
+        vluint32_t count = 0;
+        for (vluint32_t code = 0; code <= m_nextCode; ++code) {
+            const vluint32_t enabled = m_enabledCounts[code];
+            m_enabledCounts[code] = count;
+            count += enabled;
+        }
+        m_enabledCountsp = &m_enabledCounts[0];
+    }
+
     // Get the direct access pointer to the code strings
     m_suffixesp = &m_suffixes[0];  // Note: C++11 m_suffixes.data();
 
@@ -214,6 +480,13 @@ void VerilatedVcd::openNext(bool incFilename) {
         // Find _0000.{ext} in filename
         std::string name = m_filename;
         size_t pos = name.rfind('.');
+        if (vcdIsGzName(name) && pos != 0 && pos != std::string::npos) {
+            // Keep any {ext} before the .gz, so .vcd.gz becomes _cat0000.vcd.gz
+            size_t extpos = name.rfind('.', pos - 1);
+            if (extpos != std::string::npos && name.find('/', extpos) == std::string::npos) {
+                pos = extpos;
+            }
+        }
         if (pos > 8 && 0 == strncmp("_cat", name.c_str() + pos - 8, 4)
             && isdigit(name.c_str()[pos - 4]) && isdigit(name.c_str()[pos - 3])
             && isdigit(name.c_str()[pos - 2]) && isdigit(name.c_str()[pos - 1])) {
@@ -234,7 +507,12 @@ void VerilatedVcd::openNext(bool incFilename) {
         }
         m_filename = name;
     }
-    if (m_filename[0] == '|') {
+    if (m_flightSegs) {
+        // Flight recorder files are only opened by flightDump
+        m_flightHeader.clear();
+        m_flightRing.clear();
+        m_flightDirty = false;
+    } else if (m_filename[0] == '|') {
         assert(0);  // Not supported yet.
     } else {
         // cppcheck-suppress duplicateExpression
@@ -247,6 +525,11 @@ void VerilatedVcd::openNext(bool incFilename) {
     m_isOpen = true;
     m_fullDump = true;  // First dump must be full
     m_wroteBytes = 0;
+    // Raw rollover files each start with the header; the first file gets
+    // it from open()
+    if (m_binary && !m_binaryHeader.empty()) {
+        bufferAppend(m_binaryHeader.data(), m_binaryHeader.size());
+    }
 }
 
 void VerilatedVcd::makeNameMap() {
@@ -292,6 +575,11 @@ void VerilatedVcd::deleteNameMap() {
 VerilatedVcd::~VerilatedVcd() {
     close();
     if (m_wrBufp) VL_DO_CLEAR(delete[] m_wrBufp, m_wrBufp = NULL);
+    if (m_wrSparep) VL_DO_CLEAR(delete[] m_wrSparep, m_wrSparep = NULL);
+#ifdef VL_THREADED
+    if (m_shardsp) VL_DO_CLEAR(delete m_shardsp, m_shardsp = NULL);
+#endif
+    if (m_isShard) m_sigs_oldvalp = NULL;  // Owned by the parent
     if (m_sigs_oldvalp) VL_DO_CLEAR(delete[] m_sigs_oldvalp, m_sigs_oldvalp = NULL);
     deleteNameMap();
     if (m_filep && m_fileNewed) VL_DO_CLEAR(delete m_filep, m_filep = NULL);
@@ -307,8 +595,9 @@ void VerilatedVcd::closePrev() {
     if (!isOpen()) return;
 
     bufferFlush();
+    bufferWait();
     m_isOpen = false;
-    m_filep->close();
+    if (!m_flightSegs) m_filep->close();
 }
 
 void VerilatedVcd::closeErr() {
@@ -319,7 +608,10 @@ void VerilatedVcd::closeErr() {
 
     // No buffer flush, just fclose
     m_isOpen = false;
-    m_filep->close();  // May get error, just ignore it
+#ifdef VL_TRACE_THREADED
+    if (m_workerp) m_workerp->wait();  // Ignore any further error
+#endif
+    if (!m_flightSegs) m_filep->close();  // May get error, just ignore it
 }
 
 void VerilatedVcd::close() {
@@ -331,7 +623,16 @@ void VerilatedVcd::close() {
         printTime(m_timeLastDump);
         printStr(" $end\n");
     }
+    if (m_flightSegs) flightFinish();
     closePrev();
+#ifdef VL_TRACE_THREADED
+    if (m_workerp) VL_DO_CLEAR(delete m_workerp, m_workerp = NULL);
+    if (m_wrSparep) VL_DO_CLEAR(delete[] m_wrSparep, m_wrSparep = NULL);
+#endif
+    m_flightHeader.clear();
+    m_flightRing.clear();
+    m_flightDirty = false;
+    m_binaryHeader.clear();
 }
 
 void VerilatedVcd::printStr(const char* str) {
@@ -374,6 +675,11 @@ void VerilatedVcd::bufferResize(vluint64_t minsize) {
         m_writep = m_wrBufp + (m_writep - oldbufp);
         m_wrFlushp = m_wrBufp + m_wrChunkSize * 6;
         VL_DO_CLEAR(delete[] oldbufp, oldbufp = NULL);
+        if (m_wrSparep) {
+            bufferWait();  // Writer thread may still be using the spare
+            VL_DO_CLEAR(delete[] m_wrSparep, m_wrSparep = NULL);
+            m_wrSparep = new char[m_wrChunkSize * 8];
+        }
     }
 }
 
@@ -382,32 +688,167 @@ void VerilatedVcd::bufferFlush() VL_MT_UNSAFE_ONE {
     // We add output data to m_writep.
     // When it gets nearly full we dump it using this routine which calls write()
     // This is much faster than using buffered I/O
+    if (VL_UNLIKELY(m_isShard)) {
+        // Called from a thread pool worker; the parent appends the shard
+        shardGrow();
+        return;
+    }
     m_assertOne.check();
     if (VL_UNLIKELY(!isOpen())) return;
-    char* wp = m_wrBufp;
-    while (true) {
-        ssize_t remaining = (m_writep - wp);
-        if (remaining == 0) break;
-        errno = 0;
-        ssize_t got = m_filep->write(wp, remaining);
-        if (got > 0) {
-            wp += got;
-            m_wroteBytes += got;
-        } else if (got < 0) {
-            if (errno != EAGAIN && errno != EINTR) {
-                // write failed, presume error (perhaps out of disk space)
-                std::string msg = std::string("VerilatedVcd::bufferFlush: ") + strerror(errno);
-                VL_FATAL_MT("", 0, "", msg.c_str());
-                closeErr();
-                break;
-            }
+    ssize_t len = m_writep - m_wrBufp;
+    if (VL_UNLIKELY(m_binaryHeading)) {
+        // Raw header being kept by open()
+        m_binaryHeader.append(m_wrBufp, len);
+        m_writep = m_wrBufp;
+        return;
+    }
+    if (m_flightSegs) {
+        // Append to the newest segment (or before the first, the header)
+        std::string& segment = m_flightRing.empty() ? m_flightHeader : m_flightRing.back();
+        segment.append(m_wrBufp, len);
+        m_wroteBytes += len;
+        m_writep = m_wrBufp;
+        if (len) m_flightDirty = true;
+        return;
+    }
+#ifdef VL_TRACE_THREADED
+    if (m_workerp) {
+        // Once the other buffer is written, hand this one to the writer
+        // thread and continue filling the other
+        bufferWait();
+        if (VL_UNLIKELY(!isOpen())) return;
+        if (len) {
+            m_workerp->write(m_wrBufp, len);
+            std::swap(m_wrBufp, m_wrSparep);
+            m_wrFlushp = m_wrBufp + m_wrChunkSize * 6;
+            m_wroteBytes += len;
         }
+        m_writep = m_wrBufp;
+        return;
+    }
+#endif
+    if (int errnum = vcdWriteAll(m_filep, m_wrBufp, len)) {
+        bufferError(errnum);
+    } else {
+        m_wroteBytes += len;
     }
 
     // Reset buffer
     m_writep = m_wrBufp;
 }
 
+void VerilatedVcd::bufferWait() VL_MT_UNSAFE_ONE {
+    // Wait for the writer thread, if any, to finish writing the buffer
+    // handed to it by bufferFlush
+#ifdef VL_TRACE_THREADED
+    if (m_workerp) {
+        if (int errnum = m_workerp->wait()) bufferError(errnum);
+    }
+#endif
+}
+
+void VerilatedVcd::bufferError(int errnum) {
+    std::string msg = std::string("VerilatedVcd::bufferFlush: ") + strerror(errnum);
+    VL_FATAL_MT("", 0, "", msg.c_str());
+    closeErr();
+}
+
+void VerilatedVcd::bufferAppend(const char* bufp, size_t len) {
+    // Copy in pieces, as bufferCheck only guarantees space for one chunk
+    while (len) {
+        size_t piece = std::min<size_t>(len, m_wrChunkSize);
+        memcpy(m_writep, bufp, piece);
+        m_writep += piece;
+        bufp += piece;
+        len -= piece;
+        bufferCheck();
+    }
+}
+
+void VerilatedVcd::shardGrow() {
+    // Double the shard buffer, keeping the same slop above m_wrFlushp
+    vluint64_t size = (m_wrFlushp - m_wrBufp) + m_wrChunkSize * 2;
+    vluint64_t used = m_writep - m_wrBufp;
+    char* oldbufp = m_wrBufp;
+    m_wrBufp = new char[size * 2];
+    memcpy(m_wrBufp, oldbufp, used);
+    m_writep = m_wrBufp + used;
+    m_wrFlushp = m_wrBufp + size * 2 - m_wrChunkSize * 2;
+    VL_DO_CLEAR(delete[] oldbufp, oldbufp = NULL);
+}
+
+void VerilatedVcd::flush() VL_MT_UNSAFE_ONE {
+    // This function is on the flush() call path
+    if (m_flightSegs) {
+        // Flushes after $stop or $fatal are the last chance to keep the
+        // window; otherwise it stays in memory until close()
+        if (VL_UNLIKELY(Verilated::gotFinish())) flightFinish();
+        return;
+    }
+    bufferFlush();
+    bufferWait();
+}
+
+//=============================================================================
+// Flight recorder
+
+void VerilatedVcd::flightRecorder(size_t segmentKB, size_t segments) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (VL_UNLIKELY(isOpen())) {
+        VL_FATAL_MT(__FILE__, __LINE__, "",
+                    "Internal: VerilatedVcd::flightRecorder called with already open file");
+    }
+    m_flightSegBytes = std::max<size_t>(segmentKB, 1) * 1024;
+    m_flightSegs = std::max<size_t>(segments, 1);
+}
+
+void VerilatedVcd::flightNext() {
+    // Called at a dump boundary when the newest segment is full
+    bufferFlush();
+    std::string segment;
+    if (m_flightRing.size() >= m_flightSegs) {
+        // Drop the oldest segment, reusing its storage
+        segment.swap(m_flightRing.front());
+        m_flightRing.pop_front();
+        segment.clear();
+    }
+    m_flightRing.push_back(std::string());
+    m_flightRing.back().swap(segment);
+    m_fullDump = true;  // Segment must stand alone
+}
+
+void VerilatedVcd::flightFinish() {
+    // This function is on the flush() call path
+    // Write the window at the end of simulation, once unless more was recorded
+    bufferFlush();
+    if (m_flightDirty) flightDump();
+}
+
+void VerilatedVcd::flightDump(const char* filename) VL_MT_UNSAFE_ONE {
+    // This function is on the flush() call path
+    m_assertOne.check();
+    if (!m_flightSegs || !isOpen()) return;
+    bufferFlush();
+    const std::string name = filename ? filename : m_filename;
+    // Report errors as warnings, as may be called while already handling a $fatal
+    if (!m_filep->open(name)) {
+        VL_PRINTF_MT("%%Warning: VerilatedVcd::flightDump: Can't open %s\n", name.c_str());
+        return;
+    }
+    int errnum = vcdWriteAll(m_filep, m_flightHeader.data(), m_flightHeader.size());
+    for (FlightRing::const_iterator it = m_flightRing.begin();
+         !errnum && it != m_flightRing.end(); ++it) {
+        errnum = vcdWriteAll(m_filep, it->data(), it->size());
+    }
+    m_filep->close();
+    if (errnum) {
+        VL_PRINTF_MT("%%Warning: VerilatedVcd::flightDump: %s: %s\n", name.c_str(),
+                     strerror(errnum));
+    } else if (!filename) {
+        m_flightDirty = false;
+    }
+}
+
 //=============================================================================
 // Simple methods
 
@@ -576,6 +1017,29 @@ void VerilatedVcd::module(const std::string& name) {
     m_modName = name;
 }
 
+void VerilatedVcd::traceInclude(const std::string& glob) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    m_filtered = true;
+    m_includes.push_back(glob);
+}
+
+void VerilatedVcd::traceExclude(const std::string& glob) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    m_filtered = true;
+    m_excludes.push_back(glob);
+}
+
+static bool vcdGlobsMatch(const std::vector<std::string>& globs, const std::string& name) {
+    // Return if name, or a scope containing it, matches any pattern
+    for (std::vector<std::string>::const_iterator it = globs.begin(); it != globs.end(); ++it) {
+        for (size_t pos = name.find('.'); true; pos = name.find('.', pos + 1)) {
+            if (VL_WILDMATCH(name.substr(0, pos).c_str(), it->c_str())) return true;
+            if (pos == std::string::npos) break;
+        }
+    }
+    return false;
+}
+
 void VerilatedVcd::declare(vluint32_t code, const char* name, const char* wirep, bool array,
                            int arraynum, bool tri, bool bussed, int msb, int lsb) {
     if (!code) {
@@ -626,6 +1090,27 @@ void VerilatedVcd::declare(vluint32_t code, const char* name, const char* wirep,
     }
     hiername += "\t" + basename;
 
+    if (m_filtered) {
+        std::string dotted = hiername;
+        for (std::string::iterator it = dotted.begin(); it != dotted.end(); ++it) {
+            if (*it == ' ' || *it == '\t') *it = '.';
+        }
+        if (!dotted.empty() && dotted[0] == '.') dotted.erase(0, 1);
+        if (array) {
+            char buf[20];
+            sprintf(buf, "(%d)", arraynum);
+            dotted += buf;
+        }
+        const bool enabled = (m_includes.empty() || vcdGlobsMatch(m_includes, dotted))
+                             && !vcdGlobsMatch(m_excludes, dotted);
+        // No suffix, so finishLine discards changes, and no $var in header
+        if (!enabled) return;
+        if (m_enabledCounts.size() < code + codesNeeded) {
+            m_enabledCounts.resize(code + codesNeeded, 0);
+        }
+        for (int i = 0; i < codesNeeded; ++i) m_enabledCounts[code + i] = 1;
+    }
+
     // Print reference
     std::string decl = "$var ";
     if (m_evcd) {
@@ -738,12 +1223,29 @@ void VerilatedVcd::finishLine(vluint32_t* oldp, char* writep) {
     writep[6] = '\n';  // The 6th index is always '\n' if it's relevant, no need to fetch it.
     // Now write back the write pointer incremented by the actual size of the
     // suffix, which was stored in the last byte of the suffix buffer entry.
-    m_writep = writep + suffixp[VL_TRACE_SUFFIX_ENTRY_SIZE - 1];
+    // Signals excluded by traceExclude/traceInclude have no suffix, so the
+    // value is discarded.
+    const int length = suffixp[VL_TRACE_SUFFIX_ENTRY_SIZE - 1];
+    m_writep = VL_LIKELY(length) ? writep + length : m_writep;
+    bufferCheck();
+}
+
+// Write a raw change record, see VL_TRACE_RAW_MAGIC; the value is already in oldp
+void VerilatedVcd::binaryLine(const vluint32_t* oldp, vluint32_t width) {
+    const vluint32_t code = oldp - m_sigs_oldvalp;
+    // Signals excluded by traceExclude/traceInclude have no suffix
+    if (VL_UNLIKELY(!m_suffixesp[(code + 1) * VL_TRACE_SUFFIX_ENTRY_SIZE - 1])) return;
+    const size_t words = ((width & ~VL_TRACE_RAW_REAL) + 31) / 32;
+    memcpy(m_writep, &code, sizeof(code));
+    memcpy(m_writep + 4, &width, sizeof(width));
+    memcpy(m_writep + 8, oldp, words * sizeof(vluint32_t));
+    m_writep += 8 + words * sizeof(vluint32_t);
     bufferCheck();
 }
 
 void VerilatedVcd::fullBit(vluint32_t* oldp, vluint32_t newval) {
     *oldp = newval;
+    if (VL_UNLIKELY(m_binary)) return binaryLine(oldp, 1);
     char* wp = m_writep;
     *wp++ = '0' | static_cast<char>(newval);
     finishLine(oldp, wp);
@@ -756,14 +1258,10 @@ void VerilatedVcd::fullBit(vluint32_t* oldp, vluint32_t newval) {
 // T_Bits is the number of used bits in the value
 template <int T_Bits> void VerilatedVcd::fullBus(vluint32_t* oldp, vluint32_t newval) {
     *oldp = newval;
+    if (VL_UNLIKELY(m_binary)) return binaryLine(oldp, T_Bits);
     char* wp = m_writep;
     *wp++ = 'b';
-    newval <<= 32 - T_Bits;
-    int bits = T_Bits;
-    do {
-        *wp++ = '0' | static_cast<char>(newval >> 31);
-        newval <<= 1;
-    } while (--bits);
+    wp = VL_BITS_ASCII(wp, newval, T_Bits);
     finishLine(oldp, wp);
 }
 // Note: No specialization for width 1, covered by 'fullBit'
@@ -802,117 +1300,33 @@ template void VerilatedVcd::fullBus<32>(vluint32_t* oldp, vluint32_t newval);
 // T_Bits is the number of used bits in the value
 void VerilatedVcd::fullQuad(vluint32_t* oldp, vluint64_t newval, int bits) {
     *reinterpret_cast<vluint64_t*>(oldp) = newval;
+    if (VL_UNLIKELY(m_binary)) return binaryLine(oldp, bits);
     char* wp = m_writep;
     *wp++ = 'b';
-    newval <<= 64 - bits;
-    // Handle the top 32 bits within the 64 bit input
-    const int bitsInTopHalf = bits - 32;
-    wp += bitsInTopHalf;
-    // clang-format off
-    switch (bitsInTopHalf) {
-    case 32: wp[-32] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 31: wp[-31] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 30: wp[-30] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 29: wp[-29] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 28: wp[-28] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 27: wp[-27] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 26: wp[-26] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 25: wp[-25] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 24: wp[-24] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 23: wp[-23] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 22: wp[-22] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 21: wp[-21] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 20: wp[-20] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 19: wp[-19] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 18: wp[-18] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 17: wp[-17] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 16: wp[-16] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 15: wp[-15] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 14: wp[-14] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 13: wp[-13] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 12: wp[-12] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 11: wp[-11] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 10: wp[-10] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 9:  wp[ -9] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 8:  wp[ -8] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 7:  wp[ -7] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 6:  wp[ -6] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 5:  wp[ -5] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 4:  wp[ -4] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 3:  wp[ -3] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 2:  wp[ -2] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    case 1:  wp[ -1] = '0' | static_cast<char>(newval >> 63); newval<<=1; //FALLTHRU
-    }
-    // clang-format on
-    // Handle the bottom 32 bits within the 64 bit input
-    int remaining = 32;
-    do {
-        *wp++ = '0' | static_cast<char>(newval >> 63);
-        newval <<= 1;
-    } while (--remaining);
+    // Handle the top 32 bits within the 64 bit input, then the bottom 32 bits
+    wp = VL_BITS_ASCII(wp, static_cast<vluint32_t>(newval >> 32), bits - 32);
+    wp = VL_BITS_ASCII(wp, static_cast<vluint32_t>(newval), 32);
     finishLine(oldp, wp);
 }
 
 void VerilatedVcd::fullArray(vluint32_t* oldp, const vluint32_t* newvalp, int bits) {
     int words = (bits + 31) / 32;
     for (int i = 0; i < words; ++i) oldp[i] = newvalp[i];
+    if (VL_UNLIKELY(m_binary)) return binaryLine(oldp, bits);
     char* wp = m_writep;
     *wp++ = 'b';
     // Handle the most significant word
     const int bitsInMSW = bits % 32 == 0 ? 32 : bits % 32;
-    vluint32_t val = newvalp[--words] << (32 - bitsInMSW);
-    wp += bitsInMSW;
-    // clang-format off
-    switch (bitsInMSW) {
-    case 32: wp[-32] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 31: wp[-31] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 30: wp[-30] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 29: wp[-29] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 28: wp[-28] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 27: wp[-27] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 26: wp[-26] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 25: wp[-25] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 24: wp[-24] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 23: wp[-23] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 22: wp[-22] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 21: wp[-21] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 20: wp[-20] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 19: wp[-19] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 18: wp[-18] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 17: wp[-17] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 16: wp[-16] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 15: wp[-15] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 14: wp[-14] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 13: wp[-13] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 12: wp[-12] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 11: wp[-11] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 10: wp[-10] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 9:  wp[ -9] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 8:  wp[ -8] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 7:  wp[ -7] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 6:  wp[ -6] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 5:  wp[ -5] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 4:  wp[ -4] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 3:  wp[ -3] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 2:  wp[ -2] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    case 1:  wp[ -1] = '0' | static_cast<char>(val >> 31); val<<=1; //FALLTHRU
-    }
-    // clang-format on
+    wp = VL_BITS_ASCII(wp, newvalp[--words], bitsInMSW);
     // Handle the remaining words
-    while (words > 0) {
-        vluint32_t val = newvalp[--words];
-        int bits = 32;
-        do {
-            *wp++ = '0' | static_cast<char>(val >> 31);
-            val <<= 1;
-        } while (--bits);
-    }
+    while (words > 0) wp = VL_BITS_ASCII(wp, newvalp[--words], 32);
     finishLine(oldp, wp);
 }
 
 void VerilatedVcd::fullFloat(vluint32_t* oldp, float newval) {
     // cppcheck-suppress invalidPointerCast
     *reinterpret_cast<float*>(oldp) = newval;
+    if (VL_UNLIKELY(m_binary)) return binaryLine(oldp, VL_TRACE_RAW_REAL | 32);
     char* wp = m_writep;
     // Buffer can't overflow before sprintf; we sized during declaration
     sprintf(wp, "r%.16g", static_cast<double>(newval));
@@ -923,6 +1337,7 @@ void VerilatedVcd::fullFloat(vluint32_t* oldp, float newval) {
 void VerilatedVcd::fullDouble(vluint32_t* oldp, double newval) {
     // cppcheck-suppress invalidPointerCast
     *reinterpret_cast<double*>(oldp) = newval;
+    if (VL_UNLIKELY(m_binary)) return binaryLine(oldp, VL_TRACE_RAW_REAL | 64);
     char* wp = m_writep;
     // Buffer can't overflow before sprintf; we sized during declaration
     sprintf(wp, "r%.16g", newval);
@@ -1112,6 +1527,11 @@ void VerilatedVcd::dumpFull(vluint64_t timeui) {
 void VerilatedVcd::dump(vluint64_t timeui) {
     m_assertOne.check();
     if (!isOpen()) return;
+    if (VL_UNLIKELY(m_flightSegs
+                    && (m_flightRing.back().size() + (m_writep - m_wrBufp)
+                        >= m_flightSegBytes))) {
+        flightNext();
+    }
     if (VL_UNLIKELY(m_fullDump)) {
         m_fullDump = false;  // No more need for next dump to be full
         dumpFull(timeui);
@@ -1122,6 +1542,7 @@ void VerilatedVcd::dump(vluint64_t timeui) {
         if (!isOpen()) return;
     }
     dumpPrep(timeui);
+    ++m_statDumps;
     Verilated::quiesce();
     for (vluint32_t ent = 0; ent < m_callbacks.size(); ++ent) {
         VerilatedVcdCallInfo* cip = m_callbacks[ent];
@@ -1129,7 +1550,79 @@ void VerilatedVcd::dump(vluint64_t timeui) {
     }
 }
 
+#ifdef VL_THREADED
+void VerilatedVcd::chgParallel(VlThreadPool* poolp, int ncbs, const VerilatedVcdCallback_t* cbsp,
+                               void* userthis, vluint32_t code) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (VL_UNLIKELY(ncbs < 2 || !poolp || !poolp->numThreads())) {
+        for (int i = 0; i < ncbs; ++i) (cbsp[i])(this, userthis, code);
+        return;
+    }
+    if (VL_UNLIKELY(!m_shardsp)) m_shardsp = new VerilatedVcdShards;
+    std::vector<VerilatedVcdShards::Chunk>& chunks = m_shardsp->m_chunks;
+    while (chunks.size() < static_cast<size_t>(ncbs - 1)) {
+        VerilatedVcdShards::Chunk chunk;
+        chunk.m_vcdp = new VerilatedVcd;
+        chunk.m_vcdp->m_isShard = true;
+        chunk.m_pendingp = &m_shardsp->m_pending;
+        chunks.push_back(chunk);
+    }
+    // Start the chunks after the first on the thread pool
+    m_shardsp->m_pending.store(ncbs - 1, std::memory_order_relaxed);
+    for (int i = 1; i < ncbs; ++i) {
+        VerilatedVcdShards::Chunk& chunk = chunks[i - 1];
+        VerilatedVcd* shardp = chunk.m_vcdp;
+        // Signal state may have been reallocated by open(), so share it again
+        shardp->m_sigs_oldvalp = m_sigs_oldvalp;
+        shardp->m_suffixesp = m_suffixesp;
+        shardp->m_filtered = m_filtered;
+        shardp->m_binary = m_binary;
+        shardp->m_enabledCountsp = m_enabledCountsp;
+        if (VL_UNLIKELY(shardp->m_wrChunkSize != m_wrChunkSize)) {
+            VL_DO_CLEAR(delete[] shardp->m_wrBufp, shardp->m_wrBufp = NULL);
+            shardp->m_wrChunkSize = m_wrChunkSize;
+            shardp->m_wrBufp = new char[m_wrChunkSize * 8];
+            shardp->m_wrFlushp = shardp->m_wrBufp + m_wrChunkSize * 6;
+        }
+        shardp->m_writep = shardp->m_wrBufp;
+        chunk.m_cb = cbsp[i];
+        chunk.m_userthis = userthis;
+        chunk.m_code = code;
+        poolp->workerp((i - 1) % poolp->numThreads())
+            ->addTask(&VerilatedVcdShards::runChunk, false, &chunk);
+    }
+    // The first chunk is first in the file, so can write directly
+    (cbsp[0])(this, userthis, code);
+    // Wait for the others, then append them in order
+    unsigned ct = 0;
+    while (VL_UNLIKELY(m_shardsp->m_pending.load(std::memory_order_acquire))) {
+        VL_CPU_RELAX();
+        if (VL_UNLIKELY(++ct > VL_LOCK_SPINS)) {
+            ct = 0;
+            std::this_thread::yield();
+        }
+    }
+    for (int i = 1; i < ncbs; ++i) {
+        VerilatedVcd* shardp = chunks[i - 1].m_vcdp;
+        bufferAppend(shardp->m_wrBufp, shardp->m_writep - shardp->m_wrBufp);
+        m_statChecked += shardp->m_statChecked;
+        m_statChanged += shardp->m_statChanged;
+        shardp->m_statChecked = shardp->m_statChanged = 0;
+    }
+}
+#endif  // VL_THREADED
+
 void VerilatedVcd::dumpPrep(vluint64_t timeui) {
+    if (VL_UNLIKELY(m_binary)) {
+        if (VL_UNLIKELY(timeui < m_timeLastDump)) timeui = m_timeLastDump;
+        m_timeLastDump = timeui;
+        const vluint32_t rec[3] = {0, static_cast<vluint32_t>(timeui),
+                                   static_cast<vluint32_t>(timeui >> 32)};
+        memcpy(m_writep, rec, sizeof(rec));
+        m_writep += sizeof(rec);
+        bufferCheck();
+        return;
+    }
     printStr("#");
     printTime(timeui);
     printStr("\n");
@@ -23,12 +23,16 @@
 #include "verilatedos.h"
 #include "verilated.h"
 
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
 
 class VerilatedVcd;
 class VerilatedVcdCallInfo;
+class VerilatedVcdWorker;
+class VerilatedVcdShards;
+class VlThreadPool;
 
 // SPDIFF_ON
 //=============================================================================
@@ -48,6 +52,29 @@ public:
     virtual ssize_t write(const char* bufp, ssize_t len) VL_MT_UNSAFE;
 };
 
+//=============================================================================
+// VerilatedVcdGzFile
+/// File handling routines writing gzip compressed output when the filename
+/// ends in ".gz", else uncompressed.  Requires compiling with VL_TRACE_GZ
+/// (see --trace-gz) and linking with -lz; this is then the default file
+/// type.
+
+class VerilatedVcdGzFile : public VerilatedVcdFile {
+private:
+    void* m_gzp;  ///< zlib gzFile, or NULL if uncompressed
+    int m_level;  ///< Compression level
+public:
+    // METHODS
+    /// Level 1 is default as is fastest, typically still giving 10x compression
+    explicit VerilatedVcdGzFile(int level = 1)
+        : m_gzp(NULL)
+        , m_level(level) {}
+    virtual ~VerilatedVcdGzFile() {}
+    virtual bool open(const std::string& name) VL_MT_UNSAFE;
+    virtual void close() VL_MT_UNSAFE;
+    virtual ssize_t write(const char* bufp, ssize_t len) VL_MT_UNSAFE;
+};
+
 //=============================================================================
 // VerilatedVcdSig
 /// Internal data on one signal being traced.
@@ -69,6 +96,22 @@ public:
 
 typedef void (*VerilatedVcdCallback_t)(VerilatedVcd* vcdp, void* userthis, vluint32_t code);
 
+//=============================================================================
+// Raw trace format
+/// When the open() filename ends in ".vtr", VerilatedVcd writes raw change
+/// records rather than VCD text, for later conversion to VCD with
+/// verilator_trace_conv.  Raw files can't be compressed.  Each file,
+/// including each rollover file, is VL_TRACE_RAW_MAGIC, then the VCD
+/// header text, then NUL padding to a 4 byte boundary, then records of
+/// 32-bit words in host byte order:
+///     0, time[31:0], time[63:32]               Time change
+///     code, width, value words (LSW first)     Value change
+/// where width is the number of bits, or with VL_TRACE_RAW_REAL set, a
+/// 32-bit float or 64-bit double value.
+
+#define VL_TRACE_RAW_MAGIC "VLTRACE1\n"  ///< First bytes of a raw trace file
+#define VL_TRACE_RAW_REAL 0x80000000U  ///< Raw trace width flag for real values
+
 //=============================================================================
 // VerilatedVcd
 /// Base class to create a Verilator VCD dump
@@ -80,6 +123,9 @@ private:
     bool m_fileNewed;  ///< m_filep needs destruction
     bool m_isOpen;  ///< True indicates open file
     bool m_evcd;  ///< True for evcd format
+    bool m_binary;  ///< True for raw change records, see VL_TRACE_RAW_MAGIC
+    bool m_binaryHeading;  ///< Writing the raw header, bufferFlush keeps it in m_binaryHeader
+    std::string m_binaryHeader;  ///< Raw header, written at the start of each rollover file
     std::string m_filename;  ///< Filename we're writing to (if open)
     vluint64_t m_rolloverMB;  ///< MB of file size to rollover at
     char m_scopeEscape;  ///< Character to separate scope components
@@ -92,6 +138,7 @@ private:
     vluint64_t m_timeLastDump;  ///< Last time we did a dump
 
     char* m_wrBufp;  ///< Output buffer
+    char* m_wrSparep;  ///< Second output buffer, being written by m_workerp
     char* m_wrFlushp;  ///< Output buffer flush trigger location
     char* m_writep;  ///< Write pointer into output buffer
     vluint64_t m_wrChunkSize;  ///< Output buffer size
@@ -101,6 +148,12 @@ private:
     const char* m_suffixesp;  ///< Pointer to first element of above
 
     vluint32_t* m_sigs_oldvalp;  ///< Pointer to old signal values
+    bool m_filtered;  ///< traceInclude/traceExclude were called
+    std::vector<std::string> m_includes;  ///< Glob patterns of signals to trace
+    std::vector<std::string> m_excludes;  ///< Glob patterns of signals to not trace
+    /// Count of enabled codes before each code, or while declaring, if code enabled
+    std::vector<vluint32_t> m_enabledCounts;
+    const vluint32_t* m_enabledCountsp;  ///< Pointer to first element of above
     typedef std::vector<VerilatedVcdSig> SigVec;
     SigVec m_sigs;  ///< Pointer to signal information
     typedef std::vector<VerilatedVcdCallInfo*> CallbackVec;
@@ -109,9 +162,29 @@ private:
     NameMap* m_namemapp;  ///< List of names for the header
 
     VerilatedAssertOneThread m_assertOne;  ///< Assert only called from single thread
+    VerilatedVcdWorker* m_workerp;  ///< Writer thread with VL_TRACE_THREADED, else NULL
+    VerilatedVcdShards* m_shardsp;  ///< Buffers for chgParallel, or NULL
+    bool m_isShard;  ///< Buffer for a chgParallel chunk, rather than a file
+    vluint64_t m_statDumps;  ///< Number of change dumps, see statDumps()
+    vluint64_t m_statChecked;  ///< Number of signals checked, see statChecked()
+    vluint64_t m_statChanged;  ///< Number of signals changed, see statChanged()
+
+    // Flight recorder; see flightRecorder()
+    size_t m_flightSegBytes;  ///< Bytes after which to start a new segment
+    size_t m_flightSegs;  ///< Number of segments to keep, 0 = not flight recording
+    std::string m_flightHeader;  ///< Header text, written before the segments
+    typedef std::deque<std::string> FlightRing;
+    FlightRing m_flightRing;  ///< Segments, oldest first, each starting with a full dump
+    bool m_flightDirty;  ///< Recorded since the window was last written to the open() file
 
     void bufferResize(vluint64_t minsize);
     void bufferFlush() VL_MT_UNSAFE_ONE;
+    void bufferWait() VL_MT_UNSAFE_ONE;
+    void bufferError(int errnum);
+    void bufferAppend(const char* bufp, size_t len);
+    void shardGrow();
+    void flightNext();
+    void flightFinish();
     inline void bufferCheck() {
         // Flush the write buffer if there's not enough space left for new information
         // We only call this once per vector, so we need enough slop for a very wide "b###" line
@@ -137,6 +210,7 @@ private:
     char* writeCode(char* writep, vluint32_t code);
 
     void finishLine(vluint32_t* oldp, char* writep);
+    void binaryLine(const vluint32_t* oldp, vluint32_t width);
 
     // CONSTRUCTORS
     VL_UNCOPYABLE(VerilatedVcd);
@@ -156,6 +230,20 @@ public:
     void scopeEscape(char flag) { m_scopeEscape = flag; }
     /// Is this an escape?
     inline bool isScopeEscape(char c) { return isspace(c) || c == m_scopeEscape; }
+    /// Number of change dumps made, excluding full dumps
+    vluint64_t statDumps() const { return m_statDumps; }
+    /// Number of signals checked for changes over all change dumps.
+    /// Only signals whose activity flag was set are checked.
+    vluint64_t statChecked() const { return m_statChecked; }
+    /// Number of signals found changed over all change dumps
+    vluint64_t statChanged() const { return m_statChanged; }
+    /// Before open(), trace only signals matching the given glob pattern
+    /// (and any other traceInclude patterns)
+    void traceInclude(const std::string& glob) VL_MT_UNSAFE_ONE;
+    /// Before open(), do not trace signals matching the given glob pattern
+    void traceExclude(const std::string& glob) VL_MT_UNSAFE_ONE;
+    /// Before open(), keep dumps in memory rather than writing the file
+    void flightRecorder(size_t segmentKB, size_t segments) VL_MT_UNSAFE_ONE;
 
     // METHODS
     /// Open the file; call isOpen() to see if errors
@@ -163,7 +251,9 @@ public:
     void openNext(bool incFilename);  ///< Open next data-only file
     void close() VL_MT_UNSAFE_ONE;  ///< Close the file
     /// Flush any remaining data to this file
-    void flush() VL_MT_UNSAFE_ONE { bufferFlush(); }
+    void flush() VL_MT_UNSAFE_ONE;
+    /// With flightRecorder, write the recorded window to a file
+    void flightDump(const char* filename = NULL) VL_MT_UNSAFE_ONE;
     /// Flush any remaining data from all files
     static void flush_all() VL_MT_UNSAFE_ONE;
 
@@ -208,6 +298,32 @@ public:
     // Inside dumping routines used by Verilator
 
     vluint32_t* oldp(vluint32_t code) { return m_sigs_oldvalp + code; }
+    /// Return if any code from code to endCode-1 is being traced
+    bool isEnabledRange(vluint32_t code, vluint32_t endCode) const {
+        return !m_filtered || m_enabledCountsp[endCode] != m_enabledCountsp[code];
+    }
+    /// Count signals about to be checked for changes, see statChecked().
+    /// Only counted with VL_TRACE_STATS, from --trace-fine-activity.
+    void statCheckedInc(vluint32_t count) {
+#ifdef VL_TRACE_STATS
+        m_statChecked += count;
+#endif
+    }
+    /// Count a signal found changed, see statChanged()
+    inline void statChangedInc() {
+#ifdef VL_TRACE_STATS
+        ++m_statChanged;
+#endif
+    }
+
+#ifdef VL_THREADED
+    /// Inside dumping routines, call each change callback, in parallel
+    /// using the given thread pool.  All but the first callback write into
+    /// separate buffers, which are appended to the file in callback order.
+    /// The callbacks must trace disjoint signals.
+    void chgParallel(VlThreadPool* poolp, int ncbs, const VerilatedVcdCallback_t* cbsp,
+                     void* userthis, vluint32_t code) VL_MT_UNSAFE_ONE;
+#endif
 
 #ifndef VL_TRACE_VCD_OLD_API
 
@@ -226,31 +342,47 @@ public:
 
     inline void chgBit(vluint32_t* oldp, vluint32_t newval) {
         const vluint32_t diff = *oldp ^ newval;
-        if (VL_UNLIKELY(diff)) fullBit(oldp, newval);
+        if (VL_UNLIKELY(diff)) {
+            statChangedInc();
+            fullBit(oldp, newval);
+        }
     }
     template <int T_Bits> inline void chgBus(vluint32_t* oldp, vluint32_t newval) {
         const vluint32_t diff = *oldp ^ newval;
-        if (VL_UNLIKELY(diff)) fullBus<T_Bits>(oldp, newval);
+        if (VL_UNLIKELY(diff)) {
+            statChangedInc();
+            fullBus<T_Bits>(oldp, newval);
+        }
     }
     inline void chgQuad(vluint32_t* oldp, vluint64_t newval, int bits) {
         const vluint64_t diff = *reinterpret_cast<vluint64_t*>(oldp) ^ newval;
-        if (VL_UNLIKELY(diff)) fullQuad(oldp, newval, bits);
+        if (VL_UNLIKELY(diff)) {
+            statChangedInc();
+            fullQuad(oldp, newval, bits);
+        }
     }
     inline void chgArray(vluint32_t* oldp, const vluint32_t* newvalp, int bits) {
-        for (int i = 0; i < (bits + 31) / 32; ++i) {
-            if (VL_UNLIKELY(oldp[i] ^ newvalp[i])) {
-                fullArray(oldp, newvalp, bits);
-                return;
-            }
+        // Accumulate differences without branching, so the loop may vectorize
+        vluint32_t diff = 0;
+        for (int i = 0; i < (bits + 31) / 32; ++i) diff |= oldp[i] ^ newvalp[i];
+        if (VL_UNLIKELY(diff)) {
+            statChangedInc();
+            fullArray(oldp, newvalp, bits);
         }
     }
     inline void chgFloat(vluint32_t* oldp, float newval) {
         // cppcheck-suppress invalidPointerCast
-        if (VL_UNLIKELY(*reinterpret_cast<float*>(oldp) != newval)) fullFloat(oldp, newval);
+        if (VL_UNLIKELY(*reinterpret_cast<float*>(oldp) != newval)) {
+            statChangedInc();
+            fullFloat(oldp, newval);
+        }
     }
     inline void chgDouble(vluint32_t* oldp, double newval) {
         // cppcheck-suppress invalidPointerCast
-        if (VL_UNLIKELY(*reinterpret_cast<double*>(oldp) != newval)) fullDouble(oldp, newval);
+        if (VL_UNLIKELY(*reinterpret_cast<double*>(oldp) != newval)) {
+            statChangedInc();
+            fullDouble(oldp, newval);
+        }
     }
 
 #else  // VL_TRACE_VCD_OLD_API
@@ -439,6 +571,8 @@ public:
     /// Open a new VCD file
     /// This includes a complete header dump each time it is called,
     /// just as if this object was deleted and reconstructed.
+    /// A filename ending in ".vtr" writes the raw trace format, which is
+    /// faster to write; convert it to VCD with verilator_trace_conv.
     void open(const char* filename) VL_MT_UNSAFE_ONE { m_sptrace.open(filename); }
     /// Continue a VCD dump by rotating to a new file name
     /// The header is only in the first file created, this allows
@@ -446,6 +580,38 @@ public:
     void openNext(bool incFilename = true) VL_MT_UNSAFE_ONE { m_sptrace.openNext(incFilename); }
     /// Set size in megabytes after which new file should be created
     void rolloverMB(size_t rolloverMB) { m_sptrace.rolloverMB(rolloverMB); }
+    /// Before open(), trace only signals matching the given glob pattern
+    /// (and any other traceInclude patterns), e.g. "top.t.u_core.*".
+    /// A pattern matching a scope includes all signals under that scope.
+    void traceInclude(const std::string& glob) { m_sptrace.traceInclude(glob); }
+    /// Before open(), do not trace signals matching the given glob pattern,
+    /// or under a scope matching it.  Exclusions take precedence.
+    void traceExclude(const std::string& glob) { m_sptrace.traceExclude(glob); }
+    /// Before open(), enable flight recording: rather than writing the file,
+    /// keep the most recent dumps in memory, in the given number of
+    /// segments of about segmentKB kilobytes each.  Each segment starts
+    /// with a full dump, so the window is always a valid VCD.  The window is
+    /// written to the open() filename by flightDump(), by close(), or on
+    /// $stop, $fatal and assertion failures; other flush() calls don't
+    /// write it.  Only VCD traces have a flight recorder, not FST.
+    void flightRecorder(size_t segmentKB, size_t segments) {
+        m_sptrace.flightRecorder(segmentKB, segments);
+    }
+    /// Write the flight recorder window, to the given file or if NULL the
+    /// open() filename
+    void flightDump(const char* filename = NULL) VL_MT_UNSAFE_ONE {
+        m_sptrace.flightDump(filename);
+    }
+    /// Number of change dumps made, excluding full dumps.  With
+    /// statChecked() and statChanged() this gives the average number of
+    /// signals checked, and found changed, per dump.
+    vluint64_t statDumps() const { return m_sptrace.statDumps(); }
+    /// Number of signals checked for changes over all change dumps.
+    /// This and statChanged() are only counted when the model was
+    /// Verilated with --trace-fine-activity, and are otherwise zero.
+    vluint64_t statChecked() const { return m_sptrace.statChecked(); }
+    /// Number of signals found changed over all change dumps
+    vluint64_t statChanged() const { return m_sptrace.statChanged(); }
     /// Close dump
     void close() VL_MT_UNSAFE_ONE { m_sptrace.close(); }
     /// Flush dump
@@ -27,10 +27,14 @@
 #include "verilated_vpi.h"
 #include "verilated_imp.h"
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
 #include <sstream>
+#include <vector>
+
+#include VL_INCLUDE_UNORDERED_MAP
 
 //======================================================================
 // Internal constants
@@ -187,7 +191,6 @@ public:
 class VerilatedVpioVar : public VerilatedVpio {
     const VerilatedVar* m_varp;
     const VerilatedScope* m_scopep;
-    vluint8_t* m_prevDatap;  // Previous value of data, for cbValueChange
     union {
         vluint8_t u8[4];
         vluint32_t u32;
@@ -206,14 +209,11 @@ public:
         : m_varp(varp)
         , m_scopep(scopep)
         , m_index(0) {
-        m_prevDatap = NULL;
         m_mask.u32 = VL_MASK_I(varp->packed().elements());
         m_entSize = varp->entSize();
         m_varDatap = varp->datap();
     }
-    virtual ~VerilatedVpioVar() {
-        if (m_prevDatap) VL_DO_CLEAR(delete[] m_prevDatap, m_prevDatap = NULL);
-    }
+    virtual ~VerilatedVpioVar() {}
     static inline VerilatedVpioVar* castp(vpiHandle h) {
         return dynamic_cast<VerilatedVpioVar*>(reinterpret_cast<VerilatedVpio*>(h));
     }
@@ -234,14 +234,7 @@ public:
         out = std::string(m_scopep->name()) + "." + name();
         return out.c_str();
     }
-    void* prevDatap() const { return m_prevDatap; }
     void* varDatap() const { return m_varDatap; }
-    void createPrevDatap() {
-        if (VL_UNLIKELY(!m_prevDatap)) {
-            m_prevDatap = new vluint8_t[entSize()];
-            memcpy(prevDatap(), varp()->datap(), entSize());
-        }
-    }
 };
 
 class VerilatedVpioMemoryWord : public VerilatedVpioVar {
@@ -383,12 +376,77 @@ struct VerilatedVpiTimedCbsCmp {
     }
 };
 
+struct VerilatedVpiValueWatch {
+    /// Model data with cbValueChange callbacks on it.  All callbacks on the
+    /// same data share one watch, so the data is compared once per
+    /// callValueCbs however many callbacks are registered.
+    /// Only what the compare needs is here, so the watches stay dense.
+    vluint8_t* m_datap;  // Data being watched
+    vluint32_t m_size;  // Size of data in bytes
+    vluint32_t m_live;  // Number of callbacks not removed
+    size_t m_prevOffset;  // Offset of previous value in VerilatedVpiImp::m_valuePrev
+    VerilatedVpiValueWatch(vluint8_t* datap, vluint32_t size, size_t prevOffset)
+        : m_datap(datap)
+        , m_size(size)
+        , m_live(0)
+        , m_prevOffset(prevOffset) {}
+};
+
+struct VerilatedVpiNameKey {
+    /// Name in a lookup table; not a C string, so part of a name can be looked up
+    const char* m_namep;  // Name, not necessarily terminated at m_len
+    size_t m_len;  // Length of name
+    VerilatedVpiNameKey(const char* namep, size_t len)
+        : m_namep(namep)
+        , m_len(len) {}
+};
+
+struct VerilatedVpiNameKeyHash {
+    size_t operator()(const VerilatedVpiNameKey& key) const {
+        // FNV-1a
+        size_t hash = 2166136261U;
+        for (size_t i = 0; i < key.m_len; ++i) {
+            hash = (hash ^ static_cast<vluint8_t>(key.m_namep[i])) * 16777619U;
+        }
+        return hash;
+    }
+};
+
+struct VerilatedVpiNameKeyEqual {
+    bool operator()(const VerilatedVpiNameKey& a, const VerilatedVpiNameKey& b) const {
+        return a.m_len == b.m_len && std::memcmp(a.m_namep, b.m_namep, a.m_len) == 0;
+    }
+};
+
+struct VerilatedVpiScopeEntry {
+    /// A scope and hash of its variables, for vpi_handle_by_name
+    typedef vl_unordered_map<VerilatedVpiNameKey, const VerilatedVar*, VerilatedVpiNameKeyHash,
+                             VerilatedVpiNameKeyEqual>
+        VarIndex;
+    const VerilatedScope* m_scopep;  // Scope
+    VarIndex m_vars;  // Variables of the scope, keys point to the VerilatedVar names
+    VerilatedVpiScopeEntry()
+        : m_scopep(NULL) {}
+    const VerilatedVar* varFind(const char* namep) const {
+        VarIndex::const_iterator it = m_vars.find(VerilatedVpiNameKey(namep, strlen(namep)));
+        if (it == m_vars.end()) return NULL;
+        return it->second;
+    }
+};
+
 class VerilatedVpiError;
 
 class VerilatedVpiImp {
     enum { CB_ENUM_MAX_VALUE = cbAtEndOfSimTime + 1 };  // Maxium callback reason
     typedef std::list<VerilatedVpioCb*> VpioCbList;
     typedef std::set<std::pair<QData, VerilatedVpioCb*>, VerilatedVpiTimedCbsCmp> VpioTimedCbs;
+    typedef std::vector<VerilatedVpiValueWatch> VpioValueWatches;
+    // Deque so list iterators survive adding a watch from a callback
+    typedef std::deque<VpioCbList> VpioValueCbs;
+    typedef std::map<std::pair<vluint8_t*, vluint32_t>, size_t> VpioValueWatchMap;
+    typedef vl_unordered_map<VerilatedVpiNameKey, VerilatedVpiScopeEntry, VerilatedVpiNameKeyHash,
+                             VerilatedVpiNameKeyEqual>
+        VpioScopeIndex;
 
     struct product_info {
         PLI_BYTE8* product;
@@ -396,19 +454,39 @@ class VerilatedVpiImp {
 
     VpioCbList m_cbObjLists[CB_ENUM_MAX_VALUE];  // Callbacks for each supported reason
     VpioTimedCbs m_timedCbs;  // Time based callbacks
+    VpioValueWatches m_valueWatches;  // Data with cbValueChange callbacks, in add order
+    VpioValueCbs m_valueCbs;  // Callbacks of each watch, NULL if removed
+    VpioValueWatchMap m_valueWatchMap;  // Index into m_valueWatches by data and size
+    std::vector<vluint8_t> m_valuePrev;  // Previous values of all watched data
+    std::vector<size_t> m_valueChanged;  // Watches found changed by callValueCbs
+    bool m_inValueCbs;  // Calling value callbacks, so removes must not erase
+    VpioScopeIndex m_scopeIndex;  // Scopes by name, built on first use
+    vluint64_t m_scopeIndexGeneration;  // VerilatedImp::scopeGeneration() m_scopeIndex is of
     VerilatedVpiError* m_errorInfop;  // Container for vpi error info
     VerilatedAssertOneThread m_assertOne;  ///< Assert only called from single thread
 
     static VerilatedVpiImp s_s;  // Singleton
 
 public:
-    VerilatedVpiImp() { m_errorInfop = NULL; }
+    VerilatedVpiImp() {
+        m_inValueCbs = false;
+        m_scopeIndexGeneration = 0;
+        m_errorInfop = NULL;
+    }
     ~VerilatedVpiImp() {}
     static void assertOneCheck() { s_s.m_assertOne.check(); }
     static void cbReasonAdd(VerilatedVpioCb* vop) {
         if (vop->reason() == cbValueChange) {
             if (VerilatedVpioVar* varop = VerilatedVpioVar::castp(vop->cb_datap()->obj)) {
-                varop->createPrevDatap();
+                size_t index = valueWatchFind(varop, true);
+                VerilatedVpiValueWatch& watch = s_s.m_valueWatches[index];
+                if (!watch.m_live) {
+                    // Nothing was watching, so the previous value may be stale
+                    memcpy(&s_s.m_valuePrev[watch.m_prevOffset], watch.m_datap, watch.m_size);
+                }
+                s_s.m_valueCbs[index].push_back(vop);
+                ++watch.m_live;
+                return;
             }
         }
         if (VL_UNCOVERABLE(vop->reason() >= CB_ENUM_MAX_VALUE)) {
@@ -420,6 +498,13 @@ public:
         s_s.m_timedCbs.insert(std::make_pair(vop->time(), vop));
     }
     static void cbReasonRemove(VerilatedVpioCb* cbp) {
+        if (cbp->reason() == cbValueChange) {
+            if (VerilatedVpioVar* varop = VerilatedVpioVar::castp(cbp->cb_datap()->obj)) {
+                size_t index = valueWatchFind(varop, false);
+                if (index != s_s.m_valueWatches.size()) valueWatchRemove(index, cbp);
+                return;
+            }
+        }
         VpioCbList& cbObjList = s_s.m_cbObjLists[cbp->reason()];
         // We do not remove it now as we may be iterating the list,
         // instead set to NULL and will cleanup later
@@ -469,35 +554,130 @@ public:
     }
     static void callValueCbs() VL_MT_UNSAFE_ONE {
         assertOneCheck();
-        VpioCbList& cbObjList = s_s.m_cbObjLists[cbValueChange];
-        typedef std::set<VerilatedVpioVar*> VpioVarSet;
-        VpioVarSet update;  // set of objects to update after callbacks
-        for (VpioCbList::iterator it = cbObjList.begin(); it != cbObjList.end();) {
-            if (VL_UNLIKELY(!*it)) {  // Deleted earlier, cleanup
-                it = cbObjList.erase(it);
-                continue;
+        if (VL_UNLIKELY(s_s.m_inValueCbs)) return;  // Called from a value callback
+        VpioValueWatches& watches = s_s.m_valueWatches;
+        std::vector<size_t>& changed = s_s.m_valueChanged;
+        changed.clear();
+        // Find what changed first; callbacks may add watches, resizing the vectors
+        const vluint8_t* prevp = watches.empty() ? NULL : &s_s.m_valuePrev[0];
+        const size_t nwatches = watches.size();
+        for (size_t i = 0; i < nwatches; ++i) {
+            const VerilatedVpiValueWatch& watch = watches[i];
+            if (!watch.m_live) continue;
+            if (valueDiffers(watch.m_datap, prevp + watch.m_prevOffset, watch.m_size)) {
+                changed.push_back(i);
             }
-            VerilatedVpioCb* vop = *it++;
-            if (VerilatedVpioVar* varop = VerilatedVpioVar::castp(vop->cb_datap()->obj)) {
-                void* newDatap = varop->varDatap();
-                void* prevDatap = varop->prevDatap();  // Was malloced when we added the callback
-                VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: value_test %s v[0]=%d/%d %p %p\n",
-                                            varop->fullname(), *((CData*)newDatap),
-                                            *((CData*)prevDatap), newDatap, prevDatap););
-                if (memcmp(prevDatap, newDatap, varop->entSize()) != 0) {
-                    VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: value_callback %p %s v[0]=%d\n", vop,
-                                                varop->fullname(), *((CData*)newDatap)););
-                    update.insert(varop);
-                    vpi_get_value(vop->cb_datap()->obj, vop->cb_datap()->value);
-                    (vop->cb_rtnp())(vop->cb_datap());
+        }
+        if (VL_LIKELY(changed.empty())) return;
+        s_s.m_inValueCbs = true;
+        for (std::vector<size_t>::const_iterator cit = changed.begin(); cit != changed.end();
+             ++cit) {
+            VpioCbList& cbObjList = s_s.m_valueCbs[*cit];
+            for (VpioCbList::iterator it = cbObjList.begin(); it != cbObjList.end();) {
+                if (VL_UNLIKELY(!*it)) {  // Deleted earlier, cleanup
+                    it = cbObjList.erase(it);
+                    continue;
                 }
+                VerilatedVpioCb* vop = *it++;
+                VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: value_callback %p %p v[0]=%d\n", vop,
+                                            watches[*cit].m_datap, *watches[*cit].m_datap););
+                vpi_get_value(vop->cb_datap()->obj, vop->cb_datap()->value);
+                (vop->cb_rtnp())(vop->cb_datap());
+            }
+        }
+        s_s.m_inValueCbs = false;
+        // Update previous values after all callbacks have run
+        for (std::vector<size_t>::const_iterator cit = changed.begin(); cit != changed.end();
+             ++cit) {
+            const VerilatedVpiValueWatch& watch = watches[*cit];
+            memcpy(&s_s.m_valuePrev[watch.m_prevOffset], watch.m_datap, watch.m_size);
+        }
+    }
+
+    static const VerilatedVpiScopeEntry* scopeIndexFind(const char* namep,
+                                                        size_t len) VL_MT_UNSAFE_ONE {
+        // Find scope by the first len characters of namep
+        VpioScopeIndex& index = s_s.m_scopeIndex;
+        vluint64_t generation = VerilatedImp::scopeGeneration();
+        if (VL_UNLIKELY(generation != s_s.m_scopeIndexGeneration)) {
+            // Scopes were added or removed since the index was built
+            scopeIndexBuild();
+            s_s.m_scopeIndexGeneration = generation;
+        }
+        VpioScopeIndex::const_iterator it = index.find(VerilatedVpiNameKey(namep, len));
+        if (it == index.end()) return NULL;
+        return &(it->second);
+    }
+
+private:
+    static inline bool valueDiffers(const vluint8_t* newp, const vluint8_t* prevp,
+                                    vluint32_t size) VL_PURE {
+        // Previous values are aligned the same as the model's variables
+        switch (size) {
+        case sizeof(CData): return *newp != *prevp;
+        case sizeof(SData):
+            return *reinterpret_cast<const SData*>(newp) != *reinterpret_cast<const SData*>(prevp);
+        case sizeof(IData):
+            return *reinterpret_cast<const IData*>(newp) != *reinterpret_cast<const IData*>(prevp);
+        case sizeof(QData):
+            return *reinterpret_cast<const QData*>(newp) != *reinterpret_cast<const QData*>(prevp);
+        default: return memcmp(newp, prevp, size) != 0;
+        }
+    }
+    static size_t valueWatchFind(VerilatedVpioVar* varop, bool create) {
+        // Return index of watch on the variable's data, or m_valueWatches.size() if none
+        vluint8_t* datap = static_cast<vluint8_t*>(varop->varDatap());
+        vluint32_t size = varop->entSize();
+        std::pair<vluint8_t*, vluint32_t> key = std::make_pair(datap, size);
+        VpioValueWatchMap::const_iterator it = s_s.m_valueWatchMap.find(key);
+        if (it != s_s.m_valueWatchMap.end()) return it->second;
+        size_t index = s_s.m_valueWatches.size();
+        if (!create) return index;
+        // Keep each previous value aligned to a QData so it may be compared as one word
+        size_t offset = s_s.m_valuePrev.size();
+        s_s.m_valuePrev.resize(offset + ((size + sizeof(QData) - 1) & ~(sizeof(QData) - 1)));
+        s_s.m_valueWatchMap.insert(std::make_pair(key, index));
+        s_s.m_valueWatches.push_back(VerilatedVpiValueWatch(datap, size, offset));
+        s_s.m_valueCbs.push_back(VpioCbList());
+        return index;
+    }
+    static void valueWatchRemove(size_t index, VerilatedVpioCb* cbp) {
+        VpioCbList& cbObjList = s_s.m_valueCbs[index];
+        for (VpioCbList::iterator it = cbObjList.begin(); it != cbObjList.end(); ++it) {
+            if (*it != cbp) continue;
+            --s_s.m_valueWatches[index].m_live;
+            if (s_s.m_inValueCbs) {
+                // We may be iterating the list, instead set to NULL and cleanup later
+                *it = NULL;
+            } else {
+                cbObjList.erase(it);
             }
+            return;
         }
-        for (VpioVarSet::const_iterator it = update.begin(); it != update.end(); ++it) {
-            memcpy((*it)->prevDatap(), (*it)->varDatap(), (*it)->entSize());
+    }
+
+    static void scopeIndexBuild() VL_MT_UNSAFE_ONE {
+        // Keys point to the names owned by the scopes and variables
+        VpioScopeIndex& index = s_s.m_scopeIndex;
+        index.clear();
+        const VerilatedScopeNameMap* scopesp = VerilatedImp::scopeNameMap();
+        for (VerilatedScopeNameMap::const_iterator it = scopesp->begin(); it != scopesp->end();
+             ++it) {
+            const VerilatedScope* scopep = it->second;
+            VerilatedVpiScopeEntry& entry
+                = index[VerilatedVpiNameKey(scopep->name(), strlen(scopep->name()))];
+            entry.m_scopep = scopep;
+            VerilatedVarNameMap* varsp = scopep->varsp();
+            if (!varsp) continue;
+            for (VerilatedVarNameMap::const_iterator vit = varsp->begin(); vit != varsp->end();
+                 ++vit) {
+                entry.m_vars.insert(std::make_pair(
+                    VerilatedVpiNameKey(vit->first, strlen(vit->first)), &(vit->second)));
+            }
         }
     }
 
+public:
     static VerilatedVpiError* error_info() VL_MT_UNSAFE_ONE;  // getter for vpi error info
 };
 
@@ -1059,45 +1239,46 @@ vpiHandle vpi_handle_by_name(PLI_BYTE8* namep, vpiHandle scope) {
     _VL_VPI_ERROR_RESET();
     if (VL_UNLIKELY(!namep)) return NULL;
     VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: vpi_handle_by_name %s %p\n", namep, scope););
-    const VerilatedVar* varp = NULL;
-    const VerilatedScope* scopep;
-    VerilatedVpioScope* voScopep = VerilatedVpioScope::castp(scope);
-    std::string scopeAndName = namep;
-    if (voScopep) {
+    std::string scopeAndName;
+    if (VerilatedVpioScope* voScopep = VerilatedVpioScope::castp(scope)) {
         scopeAndName = std::string(voScopep->fullname()) + "." + namep;
         namep = const_cast<PLI_BYTE8*>(scopeAndName.c_str());
     }
+    const VerilatedVar* varp = NULL;
+    const VerilatedVpiScopeEntry* entryp;
     {
         // This doesn't yet follow the hierarchy in the proper way
-        scopep = Verilated::scopeFind(namep);
-        if (scopep) {  // Whole thing found as a scope
+        entryp = VerilatedVpiImp::scopeIndexFind(namep, strlen(namep));
+        if (entryp) {  // Whole thing found as a scope
+            const VerilatedScope* scopep = entryp->m_scopep;
             if (scopep->type() == VerilatedScope::SCOPE_MODULE) {
                 return (new VerilatedVpioModule(scopep))->castVpiHandle();
             } else {
                 return (new VerilatedVpioScope(scopep))->castVpiHandle();
             }
         }
-        const char* baseNamep = scopeAndName.c_str();
-        std::string scopename;
+        // Split without copying; the index can look up the scope part of the name
+        const char* baseNamep = namep;
+        size_t scopeLen = 0;
         const char* dotp = strrchr(namep, '.');
         if (VL_LIKELY(dotp)) {
             baseNamep = dotp + 1;
-            scopename = std::string(namep, dotp - namep);
+            scopeLen = dotp - namep;
         }
 
-        if (scopename.find('.') == std::string::npos) {
+        if (!memchr(namep, '.', scopeLen)) {
             // This is a toplevel, hence search in our TOP ports first.
-            scopep = Verilated::scopeFind("TOP");
-            if (scopep) { varp = scopep->varFind(baseNamep); }
+            entryp = VerilatedVpiImp::scopeIndexFind("TOP", strlen("TOP"));
+            if (entryp) { varp = entryp->varFind(baseNamep); }
         }
         if (!varp) {
-            scopep = Verilated::scopeFind(scopename.c_str());
-            if (!scopep) return NULL;
-            varp = scopep->varFind(baseNamep);
+            entryp = VerilatedVpiImp::scopeIndexFind(namep, scopeLen);
+            if (!entryp) return NULL;
+            varp = entryp->varFind(baseNamep);
         }
     }
     if (!varp) return NULL;
-    return (new VerilatedVpioVar(varp, scopep))->castVpiHandle();
+    return (new VerilatedVpioVar(varp, entryp->m_scopep))->castVpiHandle();
 }
 
 vpiHandle vpi_handle_by_index(vpiHandle object, PLI_INT32 indx) {
@@ -191,7 +191,8 @@ public:
         TRACE_FULL,
         TRACE_FULL_SUB,
         TRACE_CHANGE,
-        TRACE_CHANGE_SUB
+        TRACE_CHANGE_SUB,
+        TRACE_CHANGE_CHUNK
     };
     enum en m_e;
     inline AstCFuncType()
@@ -205,7 +206,8 @@ public:
     // METHODS
     bool isTrace() const {
         return (m_e == TRACE_INIT || m_e == TRACE_INIT_SUB || m_e == TRACE_FULL
-                || m_e == TRACE_FULL_SUB || m_e == TRACE_CHANGE || m_e == TRACE_CHANGE_SUB);
+                || m_e == TRACE_FULL_SUB || m_e == TRACE_CHANGE || m_e == TRACE_CHANGE_SUB
+                || m_e == TRACE_CHANGE_CHUNK);
     }
 };
 inline bool operator==(const AstCFuncType& lhs, const AstCFuncType& rhs) {
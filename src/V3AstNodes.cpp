@@ -1121,6 +1121,25 @@ void AstIfaceRefDType::dumpSmall(std::ostream& str) const {
     this->AstNodeDType::dumpSmall(str);
     str << "iface";
 }
+void AstIf::dump(std::ostream& str) const {
+    this->AstNode::dump(str);
+    if (caseSwitch()) str << " [SWITCH]";
+}
+static bool ifSwitchableExprRecurse(const AstNode* nodep) {
+    if (!nodep) return true;
+    if (VN_IS(nodep, Const) || VN_IS(nodep, NodeVarRef)) return true;
+    if (!VN_IS(nodep, NodeUniop) && !VN_IS(nodep, NodeBiop) && !VN_IS(nodep, NodeTriop)) {
+        return false;
+    }
+    return (ifSwitchableExprRecurse(nodep->op1p()) && ifSwitchableExprRecurse(nodep->op2p())
+            && ifSwitchableExprRecurse(nodep->op3p()));
+}
+bool AstIf::switchableExpr(const AstNode* nodep) {
+    // A switch evaluates the expression once rather than once per arm, so
+    // it must be side effect free, and C++ needs an integer of up to 32 bits
+    if (nodep->width() > 32 || nodep->isDouble() || nodep->isString()) return false;
+    return ifSwitchableExprRecurse(nodep);
+}
 void AstInitArray::dump(std::ostream& str) const {
     this->AstNode::dump(str);
     int n = 0;
@@ -1436,6 +1455,7 @@ void AstVar::dump(std::ostream& str) const {
         str << " [FUNC]";
     }
     if (isDpiOpenArray()) str << " [DPIOPENA]";
+    if (profCold()) str << " [COLD]";
     if (!attrClocker().unknown()) str << " [" << attrClocker().ascii() << "] ";
     str << " " << varType();
 }
@@ -1509,6 +1529,12 @@ void AstCoverDecl::dump(std::ostream& str) const {
         if (binNum()) { str << " bin" << std::dec << binNum(); }
     }
 }
+void AstCoverToggle::dump(std::ostream& str) const {
+    this->AstNode::dump(str);
+    for (BitRanges::const_iterator it = m_bitRanges.begin(); it != m_bitRanges.end(); ++it) {
+        str << " [" << std::dec << (it->first + it->second - 1) << ":" << it->first << "]";
+    }
+}
 void AstCoverInc::dump(std::ostream& str) const {
     this->AstNode::dump(str);
     str << " -> ";
@@ -1788,6 +1788,7 @@ private:
     bool m_noReset : 1;  // Do not do automated reset/randomization
     bool m_noSubst : 1;  // Do not substitute out references
     bool m_trace : 1;  // Trace this variable
+    bool m_profCold : 1;  // --var-feedback measured as rarely accessed
     VVarAttrClocker m_attrClocker;
     MTaskIdSet m_mtaskIds;  // MTaskID's that read or write this var
 
@@ -1823,6 +1824,7 @@ private:
         m_noReset = false;
         m_noSubst = false;
         m_trace = false;
+        m_profCold = false;
         m_attrClocker = VVarAttrClocker::CLOCKER_UNKNOWN;
     }
 
@@ -1971,6 +1973,8 @@ public:
     bool noReset() const { return m_noReset; }
     void noSubst(bool flag) { m_noSubst = flag; }
     bool noSubst() const { return m_noSubst; }
+    void profCold(bool flag) { m_profCold = flag; }
+    bool profCold() const { return m_profCold; }
     void trace(bool flag) { m_trace = flag; }
     // METHODS
     virtual void name(const string& name) { m_name = name; }
@@ -3379,28 +3383,39 @@ public:
 class AstCoverToggle : public AstNodeStmt {
     // Toggle analysis of given signal
     // Parents:  MODULE
-    // Children: AstCoverInc, orig var, change det var
+    // Children: AstCoverInc list, orig var, change det var
 public:
-    AstCoverToggle(FileLine* fl, AstCoverInc* incp, AstNode* origp, AstNode* changep)
-        : ASTGEN_SUPER(fl) {
-        setOp1p(incp);
+    typedef std::vector<std::pair<int, int> > BitRanges;  // (lsb, width) of orig per AstCoverInc
+
+private:
+    BitRanges m_bitRanges;  // Bits of orig counted by each AstCoverInc, in list order
+
+public:
+    AstCoverToggle(FileLine* fl, AstCoverInc* incsp, AstNode* origp, AstNode* changep,
+                   const BitRanges& bitRanges)
+        : ASTGEN_SUPER(fl)
+        , m_bitRanges(bitRanges) {
+        addNOp1p(incsp);
         setOp2p(origp);
         setOp3p(changep);
     }
     ASTNODE_NODE_FUNCS(CoverToggle)
+    virtual void dump(std::ostream& str) const;
     virtual int instrCount() const { return 3 + instrCountBranch() + instrCountLd(); }
     virtual V3Hash sameHash() const { return V3Hash(); }
-    virtual bool same(const AstNode* samep) const { return true; }
+    virtual bool same(const AstNode* samep) const {
+        return m_bitRanges == static_cast<const AstCoverToggle*>(samep)->m_bitRanges;
+    }
     virtual bool isGateOptimizable() const { return false; }
     virtual bool isPredictOptimizable() const { return true; }
     virtual bool isOutputter() const {
         return false;  // Though the AstCoverInc under this is an outputter
     }
     // but isPure()  true
-    AstCoverInc* incp() const { return VN_CAST(op1p(), CoverInc); }
-    void incp(AstCoverInc* nodep) { setOp1p(nodep); }
+    AstCoverInc* incsp() const { return VN_CAST(op1p(), CoverInc); }  // op1 = Increments
     AstNode* origp() const { return op2p(); }
     AstNode* changep() const { return op3p(); }
+    const BitRanges& bitRanges() const { return m_bitRanges; }
 };
 
 class AstGenCase : public AstNodeCase {
@@ -4249,20 +4264,27 @@ private:
     bool m_uniquePragma;  // unique case
     bool m_unique0Pragma;  // unique0 case
     bool m_priorityPragma;  // priority case
+    bool m_caseSwitch;  // Link in a V3Case equality chain, to emit as a switch
 public:
     AstIf(FileLine* fl, AstNode* condp, AstNode* ifsp, AstNode* elsesp = NULL)
         : ASTGEN_SUPER(fl, condp, ifsp, elsesp) {
         m_uniquePragma = false;
         m_unique0Pragma = false;
         m_priorityPragma = false;
+        m_caseSwitch = false;
     }
     ASTNODE_NODE_FUNCS(If)
+    virtual void dump(std::ostream& str) const;
     bool uniquePragma() const { return m_uniquePragma; }
     void uniquePragma(bool flag) { m_uniquePragma = flag; }
     bool unique0Pragma() const { return m_unique0Pragma; }
     void unique0Pragma(bool flag) { m_unique0Pragma = flag; }
     bool priorityPragma() const { return m_priorityPragma; }
     void priorityPragma(bool flag) { m_priorityPragma = flag; }
+    bool caseSwitch() const { return m_caseSwitch; }
+    void caseSwitch(bool flag) { m_caseSwitch = flag; }
+    // Return if expression may be the expression of a C++ switch
+    static bool switchableExpr(const AstNode* nodep);
 };
 
 class AstJumpLabel : public AstNodeStmt {
@@ -4826,6 +4848,14 @@ public:
     // op2 = Value to trace
     AstTraceDecl* declp() const { return m_declp; }  // Where defined
     AstNode* valuep() const { return op2p(); }
+    // op3 = --trace-array-writes flags of written elements
+    AstNode* writesp() const { return op3p(); }
+    // op4 = --trace-array-writes flags of written element blocks, last is all
+    AstNode* writeBlocksp() const { return op4p(); }
+    void writesp(AstNode* writesp, AstNode* blocksp) {
+        setOp3p(writesp);
+        setOp4p(blocksp);
+    }
 };
 
 class AstActive : public AstNode {
@@ -21,6 +21,11 @@
 //         Count calls into the function
 //      Then, if FTASK is called only once, add inline attribute
 //
+//      With --branch-feedback, read the taken/not taken counts that
+//      --prof-branches wrote to coverage.dat, and where one direction
+//      dominates mark the IF at that source line and column likely or
+//      unlikely, overriding the static guess above.
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -28,11 +33,80 @@
 
 #include "V3Global.h"
 #include "V3Branch.h"
+#include "V3Os.h"
+#include "V3Stats.h"
 #include "V3Ast.h"
+#include "VlcRead.h"
 
 #include <cstdarg>
+#include <fstream>
 #include <map>
 
+// CONFIG
+static const vluint64_t BRANCH_FEEDBACK_MIN_COUNT = 16;  // Fewer executions aren't trusted
+static const vluint64_t BRANCH_FEEDBACK_PERCENT = 90;  // Percent one way to be (un)likely
+
+//######################################################################
+// Measured branch counts, from a --prof-branches coverage.dat
+
+class BranchFeedback {
+    // TYPES
+    typedef std::pair<int, int> LineColumn;
+    typedef std::pair<string, LineColumn> FileLineKey;  // Filename, line number, column
+    typedef std::pair<vluint64_t, vluint64_t> Counts;  // Taken, not taken
+    typedef std::map<FileLineKey, Counts> CountMap;
+
+    // MEMBERS
+    CountMap m_counts;  // Counts for each branch source position
+
+public:
+    // METHODS
+    void operator()(const string& point, vluint64_t hits) {
+        // Called by vlcParseCoverage for each point
+        if (vlcKeyExtract(point, "page").compare(0, 9, "v_branch/") != 0) return;
+        // The column is the IF's source column, so IFs that later passes
+        // create on the same line are not confused with it
+        FileLineKey key = make_pair(vlcKeyExtract(point, VL_CIK_FILENAME),
+                                    make_pair(atoi(vlcKeyExtract(point, VL_CIK_LINENO).c_str()),
+                                              atoi(vlcKeyExtract(point, VL_CIK_COLUMN).c_str())));
+        // Several instances of one IF are summed together
+        Counts& counts = m_counts[key];
+        if (vlcKeyExtract(point, VL_CIK_COMMENT) == "taken") {
+            counts.first += hits;
+        } else {
+            counts.second += hits;
+        }
+    }
+    void read(const string& filename) {
+        UINFO(2, "  Read branch feedback " << filename << endl);
+        std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!is) {
+            v3fatal("Can't read --branch-feedback file: " << filename);
+            return;
+        }
+        if (!vlcParseCoverage(is, *this)) {
+            v3fatal("Corrupt binary coverage file: " << filename);
+        }
+    }
+    // Return the measured prediction for an IF, or false if not known
+    bool predict(FileLine* fl, VBranchPred& predr) const {
+        CountMap::const_iterator it = m_counts.find(
+            make_pair(fl->filename(), make_pair(fl->lineno(), fl->firstColumn())));
+        if (it == m_counts.end()) return false;
+        vluint64_t taken = it->second.first;
+        vluint64_t total = taken + it->second.second;
+        if (total < BRANCH_FEEDBACK_MIN_COUNT) return false;
+        if (taken * 100 >= total * BRANCH_FEEDBACK_PERCENT) {
+            predr = VBranchPred::BP_LIKELY;
+        } else if ((total - taken) * 100 >= total * BRANCH_FEEDBACK_PERCENT) {
+            predr = VBranchPred::BP_UNLIKELY;
+        } else {
+            predr = VBranchPred::BP_UNKNOWN;  // Measured as unpredictable; drop any guess
+        }
+        return true;
+    }
+};
+
 //######################################################################
 // Branch state, as a visitor of each AstNode
 
@@ -50,6 +124,8 @@ private:
     int m_likely;  // Excuses for branch likely taken
     int m_unlikely;  // Excuses for branch likely not taken
     CFuncVec m_cfuncsp;  // List of all tasks
+    BranchFeedback* m_feedbackp;  // Measured branch counts, or NULL
+    VDouble0 m_statFeedback;  // Statistic tracking
 
     // METHODS
     VL_DEBUG_FUNC;  // Declare debug()
@@ -88,6 +164,12 @@ private:
             } else if (likeness < 0) {
                 nodep->branchPred(VBranchPred::BP_UNLIKELY);
             }  // else leave unknown
+            VBranchPred measured;
+            if (m_feedbackp && m_feedbackp->predict(nodep->fileline(), measured /*ref*/)) {
+                UINFO(4, "  FEEDBACK " << measured.ascii() << ": " << nodep << endl);
+                nodep->branchPred(measured);
+                ++m_statFeedback;
+            }
         }
         m_likely = lastLikely;
         m_unlikely = lastUnlikely;
@@ -118,11 +200,21 @@ private:
 public:
     // CONSTRUCTORS
     explicit BranchVisitor(AstNetlist* nodep) {
+        m_feedbackp = NULL;
+        if (!v3Global.opt.branchFeedback().empty()) {
+            m_feedbackp = new BranchFeedback;
+            m_feedbackp->read(v3Global.opt.branchFeedback());
+        }
         reset();
         iterateChildren(nodep);
         calc_tasks();
     }
-    virtual ~BranchVisitor() {}
+    virtual ~BranchVisitor() {
+        if (m_feedbackp) {
+            V3Stats::addStat("Optimizations, Branch feedback hints", m_statFeedback);
+            VL_DO_CLEAR(delete m_feedbackp, m_feedbackp = NULL);
+        }
+    }
 };
 
 //######################################################################
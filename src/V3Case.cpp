@@ -24,6 +24,8 @@
 //                                                  (other items))
 //                                              body
 //              Or, converts to a if/else tree.
+//              Or, if dense, converts to an if/else-if chain of equalities,
+//              which V3EmitC emits as a C++ switch.
 //      FUTURES:
 //          Large 16+ bit tables with constants and no masking (address muxes)
 //              Enter all into std::multimap, sort by value and use a tree of < and == compares.
@@ -48,6 +50,8 @@
 #define CASE_OVERLAP_WIDTH 16  // Maximum width we can check for overlaps in
 #define CASE_BARF 999999  // Magic width when non-constant
 #define CASE_ENCODER_GROUP_DEPTH 8  // Levels of priority to be ORed together in top IF tree
+#define CASE_SWITCH_MIN_ITEMS 16  // Minimum item values to make a switch instead of a tree
+#define CASE_SWITCH_MIN_DENSITY 40  // Minimum percent of values with items to make a switch
 
 //######################################################################
 
@@ -129,6 +133,7 @@ private:
 
     // STATE
     VDouble0 m_statCaseFast;  // Statistic tracking
+    VDouble0 m_statCaseSwitch;  // Statistic tracking
     VDouble0 m_statCaseSlow;  // Statistic tracking
 
     // Per-CASE
@@ -226,6 +231,90 @@ private:
         return true;  // All is fine
     }
 
+    bool isCaseSwitch(AstCase* nodep) {
+        // Called after isCaseTreeFast.  A switch costs one indirect jump
+        // through a compiler made table, the tree up to m_caseWidth
+        // branches, so use a switch when the values are dense enough that
+        // the compiler will make a table.
+        if (!m_caseNoOverlapsAllCovered) return false;
+        if (m_caseItems < CASE_SWITCH_MIN_ITEMS) return false;
+        // Else V3EmitC would leave the chain as a linear if/else
+        if (!AstIf::switchableExpr(nodep->exprp())) return false;
+        if (static_cast<vluint64_t>(m_caseItems) * 100
+            < (1ULL << m_caseWidth) * CASE_SWITCH_MIN_DENSITY) {
+            return false;
+        }
+        for (AstCaseItem* itemp = nodep->itemsp(); itemp;
+             itemp = VN_CAST(itemp->nextp(), CaseItem)) {
+            for (AstNode* icondp = itemp->condsp(); icondp; icondp = icondp->nextp()) {
+                // Masked casez values would need a label for each match
+                if (VN_CAST(icondp, Const)->num().isFourState()) return false;
+            }
+        }
+        return true;
+    }
+
+    void replaceCaseSwitch(AstCase* nodep) {
+        // CASE(cexpr, ITEM(icond1,istmts1), ITEM(icond2 icond3,istmts2), ITEM(default,istmts3))
+        // ->  IF((cexpr==icond1), istmts1,
+        //        IF((cexpr==icond2) || (cexpr==icond3), istmts2, istmts3))
+        // No values overlap, so the order of the chain doesn't matter.
+        AstNode* cexprp = nodep->exprp()->unlinkFrBack();
+
+        // Handle any assertions
+        replaceCaseParallel(nodep, m_caseNoOverlapsAllCovered);
+
+        AstNode* rootp = NULL;
+        AstIf* lastp = NULL;
+        AstNode* defaultp = NULL;
+        for (AstCaseItem* itemp = nodep->itemsp(); itemp;
+             itemp = VN_CAST(itemp->nextp(), CaseItem)) {
+            AstNode* istmtsp = itemp->bodysp();  // Maybe null -- no action.
+            if (istmtsp) istmtsp->unlinkFrBackWithNext();
+            if (itemp->isDefault()) {  // Defaults were moved last by V3LinkDot
+                defaultp = istmtsp;
+                continue;
+            }
+            AstNode* ifexprp = NULL;
+            AstNode* icondNextp = NULL;
+            for (AstNode* icondp = itemp->condsp(); icondp; icondp = icondNextp) {
+                icondNextp = icondp->nextp();
+                icondp->unlinkFrBack();
+                AstNode* condp
+                    = AstEq::newTyped(itemp->fileline(), cexprp->cloneTree(false), icondp);
+                if (!ifexprp) {
+                    ifexprp = condp;
+                } else {
+                    ifexprp = new AstLogOr(itemp->fileline(), ifexprp, condp);
+                }
+            }
+            AstIf* newp = new AstIf(itemp->fileline(), ifexprp, istmtsp, NULL);
+            newp->caseSwitch(true);
+            if (lastp) {
+                lastp->addElsesp(newp);
+            } else {
+                rootp = newp;
+            }
+            lastp = newp;
+        }
+        if (defaultp) {
+            if (lastp) {
+                lastp->addElsesp(defaultp);
+            } else {
+                rootp = defaultp;
+            }
+        }
+
+        if (rootp) {
+            nodep->replaceWith(rootp);
+        } else {
+            nodep->unlinkFrBack();
+        }
+        VL_DO_DANGLING(nodep->deleteTree(), nodep);
+        VL_DO_DANGLING(cexprp->deleteTree(), cexprp);
+        if (debug() >= 9 && rootp) rootp->dumpTree(cout, "    _switch: ");
+    }
+
     AstNode* replaceCaseFastRecurse(AstNode* cexprp, int msb, uint32_t upperValue) {
         if (msb < 0) {
             // There's no space for a IF.  We know upperValue is thus down to a specific
@@ -473,10 +562,16 @@ private:
         iterateChildren(nodep);
         if (debug() >= 9) nodep->dumpTree(cout, " case_old: ");
         if (isCaseTreeFast(nodep) && v3Global.opt.oCase()) {
-            // It's a simple priority encoder or complete statement
-            // we can make a tree of statements to avoid extra comparisons
-            ++m_statCaseFast;
-            VL_DO_DANGLING(replaceCaseFast(nodep), nodep);
+            if (isCaseSwitch(nodep)) {
+                // Dense complete statement, make a chain that becomes a switch
+                ++m_statCaseSwitch;
+                VL_DO_DANGLING(replaceCaseSwitch(nodep), nodep);
+            } else {
+                // It's a simple priority encoder or complete statement
+                // we can make a tree of statements to avoid extra comparisons
+                ++m_statCaseFast;
+                VL_DO_DANGLING(replaceCaseFast(nodep), nodep);
+            }
         } else {
             ++m_statCaseSlow;
             VL_DO_DANGLING(replaceCaseComplicated(nodep), nodep);
@@ -496,6 +591,7 @@ public:
     }
     virtual ~CaseVisitor() {
         V3Stats::addStat("Optimizations, Cases parallelized", m_statCaseFast);
+        V3Stats::addStat("Optimizations, Cases switched", m_statCaseSwitch);
         V3Stats::addStat("Optimizations, Cases complex", m_statCaseSlow);
     }
 };
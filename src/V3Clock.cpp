@@ -286,16 +286,40 @@ private:
         // nodep->dumpTree(cout, "ct:");
         // COVERTOGGLE(INC, ORIG, CHANGE) ->
         //   IF(ORIG ^ CHANGE) { INC; CHANGE = ORIG; }
-        AstNode* incp = nodep->incp()->unlinkFrBack();
+        // With an INC per bit, compare the whole word first, and only look
+        // at the bits when it changed:
+        // COVERTOGGLE(INC0 INC1..., ORIG, CHANGE) ->
+        //   IF(ORIG != CHANGE) { IF((ORIG ^ CHANGE)[0]) INC0; IF(...[1]) INC1; ...
+        //                        CHANGE = ORIG; }
+        FileLine* fl = nodep->fileline();
         AstNode* origp = nodep->origp()->unlinkFrBack();
         AstNode* changep = nodep->changep()->unlinkFrBack();
-        AstIf* newp = new AstIf(nodep->fileline(), new AstXor(nodep->fileline(), origp, changep),
-                                incp, NULL);
+        const AstCoverToggle::BitRanges& bitRanges = nodep->bitRanges();
+        AstNode* condp;
+        AstNode* stmtsp = NULL;
+        if (bitRanges.size() == 1 && bitRanges[0].first == 0
+            && bitRanges[0].second == origp->width()) {
+            condp = new AstXor(fl, origp, changep);
+            stmtsp = nodep->incsp()->unlinkFrBack();
+        } else {
+            condp = new AstNeq(fl, origp, changep);
+            AstCoverToggle::BitRanges::const_iterator rangeIt = bitRanges.begin();
+            while (AstCoverInc* incp = nodep->incsp()) {
+                UASSERT_OBJ(rangeIt != bitRanges.end(), nodep, "More increments than bit ranges");
+                incp->unlinkFrBack();
+                AstNode* diffp = new AstXor(fl, origp->cloneTree(false), changep->cloneTree(false));
+                stmtsp = AstNode::addNext(
+                    stmtsp,
+                    new AstIf(fl, new AstSel(fl, diffp, rangeIt->first, rangeIt->second), incp,
+                              NULL));
+                ++rangeIt;
+            }
+        }
+        AstIf* newp = new AstIf(fl, condp, stmtsp, NULL);
         // We could add another IF to detect posedges, and only increment if so.
         // It's another whole branch though versus a potential memory miss.
         // We'll go with the miss.
-        newp->addIfsp(
-            new AstAssign(nodep->fileline(), changep->cloneTree(false), origp->cloneTree(false)));
+        newp->addIfsp(new AstAssign(fl, changep->cloneTree(false), origp->cloneTree(false)));
         nodep->replaceWith(newp);
         VL_DO_DANGLING(nodep->deleteTree(), nodep);
     }
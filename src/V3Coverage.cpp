@@ -21,6 +21,9 @@
 //              (V3Emit reencodes into per-module numbers for emitting.)
 //              Insert a COVERINC node at the end of the statement list
 //              for that if/else/case.
+//      With --prof-vars, also count each always and if/else/case body,
+//         so V3Coverage::varFeedback can read back how often variables
+//         are accessed, for --var-feedback.
 //
 //*************************************************************************
 
@@ -30,9 +33,28 @@
 #include "V3Global.h"
 #include "V3Coverage.h"
 #include "V3Ast.h"
+#include "V3Stats.h"
+#include "VlcRead.h"
 
+#include <algorithm>
 #include <cstdarg>
+#include <fstream>
 #include <map>
+#include <vector>
+
+// CONFIG
+static const vluint64_t VAR_FEEDBACK_COLD_RATIO = 1000;  // Accesses below hottest/this are cold
+
+//######################################################################
+// Statement that names a block's --prof-vars point, or NULL if none
+
+static AstNode* varBlockKeyp(AstNode* stmtsp) {
+    // Skip nodes that differ between the profiling and feedback builds
+    for (AstNode* nodep = stmtsp; nodep; nodep = nodep->nextp()) {
+        if (!VN_IS(nodep, Pragma) && !VN_IS(nodep, CoverInc)) return nodep;
+    }
+    return NULL;
+}
 
 //######################################################################
 // Coverage state, as a visitor of each AstNode
@@ -57,6 +79,18 @@ private:
         }
     };
 
+    struct ToggleBits {
+        int m_lsb;  // Lowest bit of point in the packed value
+        int m_width;  // Bits in point
+        AstCoverInc* m_incp;  // Increment for the point
+        ToggleBits(int lsb, int width, AstCoverInc* incp)
+            : m_lsb(lsb)
+            , m_width(width)
+            , m_incp(incp) {}
+        bool operator<(const ToggleBits& rhs) const { return m_lsb < rhs.m_lsb; }
+    };
+    typedef std::vector<ToggleBits> ToggleBitsList;
+
     // NODE STATE
     // Entire netlist:
     //  AstIf::user1()                  -> bool.  True indicates ifelse processed
@@ -91,19 +125,22 @@ private:
     }
 
     AstCoverInc* newCoverInc(FileLine* fl, const string& hier, const string& page_prefix,
-                             const string& comment, const string& trace_var_name) {
-        // For line coverage, we may have multiple if's on one line, so disambiguate if
-        // everything is otherwise identical
-        // (Don't set column otherwise as it may result in making bins not match up with
-        // different types of coverage enabled.)
-        string key = fl->filename() + "\001" + cvtToStr(fl->lineno()) + "\001" + hier + "\001"
-                     + page_prefix + "\001" + comment;
-        int column = 0;
-        FileMap::iterator it = m_fileps.find(key);
-        if (it == m_fileps.end()) {
-            m_fileps.insert(make_pair(key, column + 1));
-        } else {
-            column = (it->second)++;
+                             const string& comment, const string& trace_var_name,
+                             int column = -1) {
+        if (column < 0) {
+            // For line coverage, we may have multiple if's on one line, so disambiguate if
+            // everything is otherwise identical
+            // (Don't set column otherwise as it may result in making bins not match up with
+            // different types of coverage enabled.)
+            string key = fl->filename() + "\001" + cvtToStr(fl->lineno()) + "\001" + hier
+                         + "\001" + page_prefix + "\001" + comment;
+            column = 0;
+            FileMap::iterator it = m_fileps.find(key);
+            if (it == m_fileps.end()) {
+                m_fileps.insert(make_pair(key, column + 1));
+            } else {
+                column = (it->second)++;
+            }
         }
 
         // We could use the basename of the filename to the page, but seems
@@ -134,6 +171,14 @@ private:
         }
         return incp;
     }
+    void varsCoverInc(AstNode* stmtsp) {
+        // Count executions of a statement list, read back by --var-feedback
+        if (!v3Global.opt.profVars() || m_inModOff) return;
+        AstNode* keyp = varBlockKeyp(stmtsp);
+        if (!keyp || !keyp->fileline()->coverageOn()) return;
+        FileLine* flp = keyp->fileline();
+        stmtsp->addNext(newCoverInc(flp, "", "v_vars", "block", "", flp->firstColumn()));
+    }
     string traceNameForLine(AstNode* nodep, const string& type) {
         return "vlCoverageLineTrace_" + nodep->fileline()->filebasenameNoExt() + "__"
                + cvtToStr(nodep->fileline()->lineno()) + "_" + type;
@@ -200,80 +245,78 @@ private:
         }
     }
 
-    void toggleVarBottom(const ToggleEnt& above, const AstVar* varp) {
-        AstCoverToggle* newp = new AstCoverToggle(
-            varp->fileline(),
-            newCoverInc(varp->fileline(), "", "v_toggle", varp->name() + above.m_comment, ""),
-            above.m_varRefp->cloneTree(true), above.m_chgRefp->cloneTree(true));
-        m_modp->addStmtp(newp);
+    void toggleVarBits(const string& comment, int lsb, int width, AstVar* varp,
+                       ToggleBitsList& bits) {
+        bits.push_back(ToggleBits(
+            lsb, width,
+            newCoverInc(varp->fileline(), "", "v_toggle", varp->name() + comment, "")));
     }
 
-    void toggleVarRecurse(AstNodeDType* dtypep, int depth,  // per-iteration
-                          const ToggleEnt& above, AstVar* varp, AstVar* chgVarp) {  // Constant
+    void toggleVarPacked(AstNodeDType* dtypep, const ToggleEnt& above, AstVar* varp) {
+        // Points of a packed value are grouped by word, so V3Clock checks a
+        // whole word for changes before looking at individual bits
+        ToggleBitsList bits;
+        togglePackedRecurse(dtypep, 0, above.m_comment, varp, bits);
+        // Points were created above in documentation order; group them by bit
+        std::stable_sort(bits.begin(), bits.end());
+        const int width = dtypep->width();
+        const int wordBits = (width <= VL_QUADSIZE) ? width : VL_EDATASIZE;
+        for (ToggleBitsList::const_iterator it = bits.begin(); it != bits.end();) {
+            const int wordLsb = it->m_lsb / wordBits * wordBits;
+            int wordEnd = wordLsb;
+            AstCoverInc* incsp = NULL;
+            AstCoverToggle::BitRanges bitRanges;
+            for (; it != bits.end() && it->m_lsb < wordLsb + wordBits; ++it) {
+                wordEnd = std::max(wordEnd, it->m_lsb + it->m_width);
+                bitRanges.push_back(std::make_pair(it->m_lsb - wordLsb, it->m_width));
+                incsp = VN_CAST(AstNode::addNext(incsp, it->m_incp), CoverInc);
+            }
+            AstNode* origp = above.m_varRefp->cloneTree(true);
+            AstNode* changep = above.m_chgRefp->cloneTree(true);
+            if (wordLsb != 0 || wordEnd != width) {
+                origp = new AstSel(varp->fileline(), origp, wordLsb, wordEnd - wordLsb);
+                changep = new AstSel(varp->fileline(), changep, wordLsb, wordEnd - wordLsb);
+            }
+            m_modp->addStmtp(
+                new AstCoverToggle(varp->fileline(), incsp, origp, changep, bitRanges));
+        }
+    }
+
+    void togglePackedRecurse(AstNodeDType* dtypep, int lsb, const string& comment,
+                             AstVar* varp, ToggleBitsList& bits) {
         if (const AstBasicDType* bdtypep = VN_CAST(dtypep, BasicDType)) {
             if (bdtypep->isRanged()) {
                 for (int index_docs = bdtypep->lsb(); index_docs < bdtypep->msb() + 1;
                      index_docs++) {
                     int index_code = index_docs - bdtypep->lsb();
-                    ToggleEnt newent(above.m_comment + string("[") + cvtToStr(index_docs) + "]",
-                                     new AstSel(varp->fileline(), above.m_varRefp->cloneTree(true),
-                                                index_code, 1),
-                                     new AstSel(varp->fileline(), above.m_chgRefp->cloneTree(true),
-                                                index_code, 1));
-                    toggleVarBottom(newent, varp);
-                    newent.cleanup();
+                    toggleVarBits(comment + string("[") + cvtToStr(index_docs) + "]",
+                                  lsb + index_code, 1, varp, bits);
                 }
             } else {
-                toggleVarBottom(above, varp);
-            }
-        } else if (AstUnpackArrayDType* adtypep = VN_CAST(dtypep, UnpackArrayDType)) {
-            for (int index_docs = adtypep->lsb(); index_docs <= adtypep->msb(); ++index_docs) {
-                int index_code = index_docs - adtypep->lsb();
-                ToggleEnt newent(above.m_comment + string("[") + cvtToStr(index_docs) + "]",
-                                 new AstArraySel(varp->fileline(),
-                                                 above.m_varRefp->cloneTree(true), index_code),
-                                 new AstArraySel(varp->fileline(),
-                                                 above.m_chgRefp->cloneTree(true), index_code));
-                toggleVarRecurse(adtypep->subDTypep()->skipRefp(), depth + 1, newent, varp,
-                                 chgVarp);
-                newent.cleanup();
+                toggleVarBits(comment, lsb, bdtypep->width(), varp, bits);
             }
         } else if (AstPackArrayDType* adtypep = VN_CAST(dtypep, PackArrayDType)) {
             for (int index_docs = adtypep->lsb(); index_docs <= adtypep->msb(); ++index_docs) {
                 AstNodeDType* subtypep = adtypep->subDTypep()->skipRefp();
                 int index_code = index_docs - adtypep->lsb();
-                ToggleEnt newent(above.m_comment + string("[") + cvtToStr(index_docs) + "]",
-                                 new AstSel(varp->fileline(), above.m_varRefp->cloneTree(true),
-                                            index_code * subtypep->width(), subtypep->width()),
-                                 new AstSel(varp->fileline(), above.m_chgRefp->cloneTree(true),
-                                            index_code * subtypep->width(), subtypep->width()));
-                toggleVarRecurse(adtypep->subDTypep()->skipRefp(), depth + 1, newent, varp,
-                                 chgVarp);
-                newent.cleanup();
+                togglePackedRecurse(subtypep, lsb + index_code * subtypep->width(),
+                                    comment + string("[") + cvtToStr(index_docs) + "]", varp,
+                                    bits);
             }
         } else if (AstStructDType* adtypep = VN_CAST(dtypep, StructDType)) {
             // For now it's packed, so similar to array
             for (AstMemberDType* itemp = adtypep->membersp(); itemp;
                  itemp = VN_CAST(itemp->nextp(), MemberDType)) {
                 AstNodeDType* subtypep = itemp->subDTypep()->skipRefp();
-                int index_code = itemp->lsb();
-                ToggleEnt newent(above.m_comment + string(".") + itemp->name(),
-                                 new AstSel(varp->fileline(), above.m_varRefp->cloneTree(true),
-                                            index_code, subtypep->width()),
-                                 new AstSel(varp->fileline(), above.m_chgRefp->cloneTree(true),
-                                            index_code, subtypep->width()));
-                toggleVarRecurse(subtypep, depth + 1, newent, varp, chgVarp);
-                newent.cleanup();
+                togglePackedRecurse(subtypep, lsb + itemp->lsb(),
+                                    comment + string(".") + itemp->name(), varp, bits);
             }
         } else if (AstUnionDType* adtypep = VN_CAST(dtypep, UnionDType)) {
             // Arbitrarily handle only the first member of the union
             if (AstMemberDType* itemp = adtypep->membersp()) {
                 AstNodeDType* subtypep = itemp->subDTypep()->skipRefp();
-                ToggleEnt newent(above.m_comment + string(".") + itemp->name(),
-                                 above.m_varRefp->cloneTree(true),
-                                 above.m_chgRefp->cloneTree(true));
-                toggleVarRecurse(subtypep, depth + 1, newent, varp, chgVarp);
-                newent.cleanup();
+                togglePackedRecurse(subtypep, lsb, comment + string(".") + itemp->name(), varp,
+                                    bits);
             }
         } else {
             dtypep->v3fatalSrc("Unexpected node data type in toggle coverage generation: "
@@ -281,55 +324,94 @@ private:
         }
     }
 
+    void toggleVarRecurse(AstNodeDType* dtypep, int depth,  // per-iteration
+                          const ToggleEnt& above, AstVar* varp, AstVar* chgVarp) {  // Constant
+        if (AstUnpackArrayDType* adtypep = VN_CAST(dtypep, UnpackArrayDType)) {
+            for (int index_docs = adtypep->lsb(); index_docs <= adtypep->msb(); ++index_docs) {
+                int index_code = index_docs - adtypep->lsb();
+                ToggleEnt newent(above.m_comment + string("[") + cvtToStr(index_docs) + "]",
+                                 new AstArraySel(varp->fileline(),
+                                                 above.m_varRefp->cloneTree(true), index_code),
+                                 new AstArraySel(varp->fileline(),
+                                                 above.m_chgRefp->cloneTree(true), index_code));
+                toggleVarRecurse(adtypep->subDTypep()->skipRefp(), depth + 1, newent, varp,
+                                 chgVarp);
+                newent.cleanup();
+            }
+        } else {
+            toggleVarPacked(dtypep, above, varp);
+        }
+    }
+
     // VISITORS - LINE COVERAGE
     virtual void
     visit(AstIf* nodep) VL_OVERRIDE {  // Note not AstNodeIf; other types don't get covered
         UINFO(4, " IF: " << nodep << endl);
-        if (m_checkBlock) {
-            // An else-if.  When we iterate the if, use "elsif" marking
-            bool elsif = (VN_IS(nodep->elsesp(), If) && !VN_CAST(nodep->elsesp(), If)->nextp());
-            if (elsif) VN_CAST(nodep->elsesp(), If)->user1(true);
-            //
-            iterateAndNextNull(nodep->ifsp());
+        // Bodies are always walked, for --prof-branches; m_checkBlock, false
+        // after a $stop or coverage_block_off, only gates the line points
+        const bool checkBlock = m_checkBlock;
+        // An else-if.  When we iterate the if, use "elsif" marking
+        bool elsif = (VN_IS(nodep->elsesp(), If) && !VN_CAST(nodep->elsesp(), If)->nextp());
+        if (elsif) VN_CAST(nodep->elsesp(), If)->user1(true);
+        //
+        iterateAndNextNull(nodep->ifsp());
+        varsCoverInc(nodep->ifsp());
+        if (m_checkBlock && !m_inModOff && nodep->fileline()->coverageOn()
+            && v3Global.opt.coverageLine()) {  // if a "if" branch didn't disable it
+            UINFO(4, "   COVER: " << nodep << endl);
+            if (nodep->user1()) {
+                nodep->addIfsp(newCoverInc(nodep->fileline(), "", "v_line", "elsif",
+                                           traceNameForLine(nodep, "elsif")));
+            } else {
+                nodep->addIfsp(newCoverInc(nodep->fileline(), "", "v_line", "if",
+                                           traceNameForLine(nodep, "if")));
+            }
+        }
+        // Don't do empty else's, only empty if/case's
+        if (nodep->elsesp()) {
+            m_checkBlock = checkBlock;
+            iterateAndNextNull(nodep->elsesp());
+            varsCoverInc(nodep->elsesp());
             if (m_checkBlock && !m_inModOff && nodep->fileline()->coverageOn()
-                && v3Global.opt.coverageLine()) {  // if a "if" branch didn't disable it
+                && v3Global.opt.coverageLine()) {  // if a "else" branch didn't disable it
                 UINFO(4, "   COVER: " << nodep << endl);
-                if (nodep->user1()) {
-                    nodep->addIfsp(newCoverInc(nodep->fileline(), "", "v_line", "elsif",
-                                               traceNameForLine(nodep, "elsif")));
-                } else {
-                    nodep->addIfsp(newCoverInc(nodep->fileline(), "", "v_line", "if",
-                                               traceNameForLine(nodep, "if")));
-                }
-            }
-            // Don't do empty else's, only empty if/case's
-            if (nodep->elsesp()) {
-                m_checkBlock = true;
-                iterateAndNextNull(nodep->elsesp());
-                if (m_checkBlock && !m_inModOff && nodep->fileline()->coverageOn()
-                    && v3Global.opt.coverageLine()) {  // if a "else" branch didn't disable it
-                    UINFO(4, "   COVER: " << nodep << endl);
-                    if (!elsif) {  // elsif done inside if()
-                        nodep->addElsesp(newCoverInc(nodep->elsesp()->fileline(), "", "v_line",
-                                                     "else", traceNameForLine(nodep, "else")));
-                    }
+                if (!elsif) {  // elsif done inside if()
+                    nodep->addElsesp(newCoverInc(nodep->elsesp()->fileline(), "", "v_line",
+                                                 "else", traceNameForLine(nodep, "else")));
                 }
             }
-            m_checkBlock = true;  // Reset as a child may have cleared it
+        }
+        m_checkBlock = checkBlock;  // Reset as a child may have cleared it
+        if (v3Global.opt.profBranches() && !m_inModOff && nodep->fileline()->coverageOn()) {
+            // Taken/not taken counts, read back by --branch-feedback in V3Branch.
+            // Both points use the if's source line and column so they can be
+            // paired, and told apart from other IFs on the same line.
+            UINFO(4, "   BRANCH: " << nodep << endl);
+            FileLine* flp = nodep->fileline();
+            nodep->addIfsp(newCoverInc(flp, "", "v_branch", "taken", "", flp->firstColumn()));
+            nodep->addElsesp(
+                newCoverInc(flp, "", "v_branch", "not_taken", "", flp->firstColumn()));
         }
     }
     virtual void visit(AstCaseItem* nodep) VL_OVERRIDE {
         UINFO(4, " CASEI: " << nodep << endl);
+        // Always walked, as for AstIf, so --prof-branches sees IFs in the body
+        const bool checkBlock = m_checkBlock;
+        iterateAndNextNull(nodep->bodysp());
+        varsCoverInc(nodep->bodysp());
         if (m_checkBlock && !m_inModOff && nodep->fileline()->coverageOn()
-            && v3Global.opt.coverageLine()) {
-            iterateAndNextNull(nodep->bodysp());
-            if (m_checkBlock) {  // if the case body didn't disable it
-                UINFO(4, "   COVER: " << nodep << endl);
-                nodep->addBodysp(newCoverInc(nodep->fileline(), "", "v_line", "case",
-                                             traceNameForLine(nodep, "case")));
-            }
-            m_checkBlock = true;  // Reset as a child may have cleared it
+            && v3Global.opt.coverageLine()) {  // if the case body didn't disable it
+            UINFO(4, "   COVER: " << nodep << endl);
+            nodep->addBodysp(newCoverInc(nodep->fileline(), "", "v_line", "case",
+                                         traceNameForLine(nodep, "case")));
         }
+        m_checkBlock = checkBlock;  // Reset as a child may have cleared it
+    }
+    virtual void visit(AstAlways* nodep) VL_OVERRIDE {
+        const bool checkBlock = m_checkBlock;
+        iterateChildren(nodep);
+        varsCoverInc(nodep->bodysp());
+        m_checkBlock = checkBlock;  // Reset as a child may have cleared it
     }
     virtual void visit(AstCover* nodep) VL_OVERRIDE {
         UINFO(4, " COVER: " << nodep << endl);
@@ -377,10 +459,10 @@ private:
 
     // VISITORS - BOTH
     virtual void visit(AstNode* nodep) VL_OVERRIDE {
-        if (m_checkBlock) {
-            iterateChildren(nodep);
-            m_checkBlock = true;  // Reset as a child may have cleared it
-        }
+        // Walked even when not m_checkBlock, so --prof-branches sees every IF
+        const bool checkBlock = m_checkBlock;
+        iterateChildren(nodep);
+        m_checkBlock = checkBlock;  // Reset as a child may have cleared it
     }
 
 public:
@@ -397,6 +479,135 @@ public:
     virtual ~CoverageVisitor() {}
 };
 
+//######################################################################
+// Measured variable accesses, from a --prof-vars coverage.dat
+
+class VarFeedbackVisitor : public AstNVisitor {
+private:
+    // TYPES
+    typedef std::pair<int, int> LineColumn;
+    typedef std::pair<string, LineColumn> FileLineKey;  // Filename, line number, column
+    typedef std::map<FileLineKey, vluint64_t> CountMap;
+    typedef std::map<AstVar*, vluint64_t> HeatMap;
+
+    // NODE STATE
+    // Entire netlist:
+    //  AstVar::user1()     -> bool.  Referenced outside a measured block
+    AstUser1InUse m_inuser1;
+
+    // STATE
+    CountMap m_counts;  // Executions of each block, by position of its first statement
+    vluint64_t m_maxCount;  // Executions of the most executed block
+    HeatMap m_heat;  // Summed executions of the blocks referencing each variable
+    bool m_measured;  // In a block with a known count
+    vluint64_t m_count;  // Executions of the current block
+    VDouble0 m_statCold;  // Statistic tracking
+
+    // METHODS
+    VL_DEBUG_FUNC;  // Declare debug()
+
+    void iterateMeasured(AstNode* stmtsp, bool measured, vluint64_t count) {
+        bool oldMeasured = m_measured;
+        vluint64_t oldCount = m_count;
+        m_measured = measured;
+        m_count = count;
+        iterateAndNextNull(stmtsp);
+        m_measured = oldMeasured;
+        m_count = oldCount;
+    }
+    void iterateBlock(AstNode* stmtsp) {
+        AstNode* keyp = varBlockKeyp(stmtsp);
+        if (!keyp) return;
+        FileLine* flp = keyp->fileline();
+        CountMap::const_iterator it = m_counts.find(
+            make_pair(flp->filename(), make_pair(flp->lineno(), flp->firstColumn())));
+        if (it == m_counts.end()) {
+            iterateMeasured(stmtsp, false, 0);
+        } else {
+            iterateMeasured(stmtsp, true, it->second);
+        }
+    }
+
+    // VISITORS
+    virtual void visit(AstNetlist* nodep) VL_OVERRIDE {
+        iterateChildren(nodep);
+        if (!m_maxCount) return;  // Model never ran, so nothing is known to be cold
+        for (HeatMap::const_iterator it = m_heat.begin(); it != m_heat.end(); ++it) {
+            AstVar* varp = it->first;
+            if (!varp->user1() && it->second * VAR_FEEDBACK_COLD_RATIO < m_maxCount) {
+                UINFO(4, "  Cold " << it->second << " " << varp << endl);
+                varp->profCold(true);
+                ++m_statCold;
+            }
+        }
+    }
+    virtual void visit(AstAlways* nodep) VL_OVERRIDE {
+        iterateAndNextNull(nodep->sensesp());
+        iterateBlock(nodep->bodysp());
+    }
+    // Initial and final blocks run once, so what only they reference is cold
+    virtual void visit(AstInitial* nodep) VL_OVERRIDE {
+        iterateMeasured(nodep->bodysp(), true, 0);
+    }
+    virtual void visit(AstFinal* nodep) VL_OVERRIDE { iterateMeasured(nodep->bodysp(), true, 0); }
+    virtual void visit(AstIf* nodep) VL_OVERRIDE {
+        iterateAndNextNull(nodep->condp());
+        iterateBlock(nodep->ifsp());
+        iterateBlock(nodep->elsesp());
+    }
+    virtual void visit(AstCaseItem* nodep) VL_OVERRIDE {
+        iterateAndNextNull(nodep->condsp());
+        iterateBlock(nodep->bodysp());
+    }
+    virtual void visit(AstNodeVarRef* nodep) VL_OVERRIDE {
+        if (AstVar* varp = nodep->varp()) {
+            if (m_measured) {
+                m_heat[varp] += m_count;
+            } else {
+                varp->user1(true);  // Unknown rate, so keep it hot
+            }
+        }
+        iterateChildren(nodep);
+    }
+    virtual void visit(AstNode* nodep) VL_OVERRIDE { iterateChildren(nodep); }
+
+public:
+    // METHODS
+    void operator()(const string& point, vluint64_t hits) {
+        // Called by vlcParseCoverage for each point
+        if (vlcKeyExtract(point, "page").compare(0, 7, "v_vars/") != 0) return;
+        FileLineKey key = make_pair(vlcKeyExtract(point, VL_CIK_FILENAME),
+                                    make_pair(atoi(vlcKeyExtract(point, VL_CIK_LINENO).c_str()),
+                                              atoi(vlcKeyExtract(point, VL_CIK_COLUMN).c_str())));
+        // Several instances of one block are summed together
+        m_counts[key] += hits;
+    }
+
+    // CONSTRUCTORS
+    VarFeedbackVisitor(AstNetlist* rootp, const string& filename)
+        : m_maxCount(0)
+        , m_measured(false)
+        , m_count(0) {
+        UINFO(2, "  Read variable feedback " << filename << endl);
+        std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!is) {
+            v3fatal("Can't read --var-feedback file: " << filename);
+            return;
+        }
+        if (!vlcParseCoverage(is, *this)) {
+            v3fatal("Corrupt binary coverage file: " << filename);
+            return;
+        }
+        for (CountMap::const_iterator it = m_counts.begin(); it != m_counts.end(); ++it) {
+            m_maxCount = std::max(m_maxCount, it->second);
+        }
+        iterate(rootp);
+    }
+    virtual ~VarFeedbackVisitor() {
+        V3Stats::addStat("Optimizations, Variables measured cold", m_statCold);
+    }
+};
+
 //######################################################################
 // Coverage class functions
 
@@ -405,3 +616,9 @@ void V3Coverage::coverage(AstNetlist* rootp) {
     { CoverageVisitor visitor(rootp); }  // Destruct before checking
     V3Global::dumpCheckGlobalTree("coverage", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
 }
+
+void V3Coverage::varFeedback(AstNetlist* rootp) {
+    UINFO(2, __FUNCTION__ << ": " << endl);
+    { VarFeedbackVisitor visitor(rootp, v3Global.opt.varFeedback()); }  // Destruct before checking
+    V3Global::dumpCheckGlobalTree("varfeedback", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
+}
@@ -29,6 +29,8 @@ class V3Coverage {
 public:
     // CONSTRUCTORS
     static void coverage(AstNetlist* rootp);
+    // Mark rarely accessed variables from --var-feedback's counts
+    static void varFeedback(AstNetlist* rootp);
 };
 
 #endif  // Guard
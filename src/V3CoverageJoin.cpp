@@ -28,6 +28,18 @@
 #include <cstdarg>
 #include <vector>
 
+//######################################################################
+// Auxiliary hash class for CoverageJoinVisitor
+
+class CoverageJoinSame : public V3HashedUserSame {
+public:
+    virtual bool isSame(AstNode* node1p, AstNode* node2p) {
+        // Same signal may still be split into points differently, e.g. by
+        // struct members, so the toggles' bit ranges must match too
+        return node1p->backp()->same(node2p->backp());
+    }
+};
+
 //######################################################################
 // CoverageJoin state, as a visitor of each AstNode
 
@@ -54,6 +66,7 @@ private:
         UINFO(9, "Finding duplicates\n");
         // Note uses user4
         V3Hashed hashed;  // Duplicate code detection
+        CoverageJoinSame sameBits;  // Toggles must also count the same bits
         // Hash all of the original signals we toggle cover
         for (ToggleList::iterator it = m_toggleps.begin(); it != m_toggleps.end(); ++it) {
             AstCoverToggle* nodep = *it;
@@ -68,7 +81,7 @@ private:
                 // This prevents making chains where a->b, then c->d, then b->c, as we'll
                 // find a->b, a->c, a->d directly.
                 while (true) {
-                    V3Hashed::iterator dupit = hashed.findDuplicate(nodep->origp());
+                    V3Hashed::iterator dupit = hashed.findDuplicate(nodep->origp(), &sameBits);
                     if (dupit == hashed.end()) break;
                     //
                     AstNode* duporigp = hashed.iteratorNodep(dupit);
@@ -77,21 +90,27 @@ private:
                     // covertoggle which is immediately above, so:
                     AstCoverToggle* removep = VN_CAST(duporigp->backp(), CoverToggle);
                     UASSERT_OBJ(removep, nodep, "CoverageJoin duplicate of wrong type");
-                    UINFO(8, "  Orig " << nodep << " -->> " << nodep->incp()->declp() << endl);
-                    UINFO(8, "   dup " << removep << " -->> " << removep->incp()->declp() << endl);
-                    // The CoverDecl the duplicate pointed to now needs to point to the
-                    // original's data. I.e. the duplicate will get the coverage number
+                    UINFO(8, "  Orig " << nodep << endl);
+                    UINFO(8, "   dup " << removep << endl);
+                    // The CoverDecls the duplicate pointed to now need to point to the
+                    // original's data. I.e. the duplicate will get the coverage numbers
                     // from the non-duplicate
-                    AstCoverDecl* datadeclp = nodep->incp()->declp()->dataDeclThisp();
-                    removep->incp()->declp()->dataDeclp(datadeclp);
-                    UINFO(8, "   new " << removep->incp()->declp() << endl);
+                    AstCoverInc* incp = nodep->incsp();
+                    AstCoverInc* removeIncp = removep->incsp();
+                    while (incp && removeIncp) {
+                        AstCoverDecl* datadeclp = incp->declp()->dataDeclThisp();
+                        removeIncp->declp()->dataDeclp(datadeclp);
+                        UINFO(8, "   new " << removeIncp->declp() << endl);
+                        ++m_statToggleJoins;
+                        incp = VN_CAST(incp->nextp(), CoverInc);
+                        removeIncp = VN_CAST(removeIncp->nextp(), CoverInc);
+                    }
                     // Mark the found node as a duplicate of the first node
                     // (Not vice-versa as we have the iterator for the found node)
                     removep->unlinkFrBack();
                     VL_DO_DANGLING(pushDeletep(removep), removep);
                     // Remove node from comparison so don't hit it again
                     hashed.erase(dupit);
-                    ++m_statToggleJoins;
                 }
             }
         }
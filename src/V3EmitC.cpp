@@ -29,6 +29,7 @@
 #include <cmath>
 #include <cstdarg>
 #include <map>
+#include <set>
 #include <vector>
 #include VL_INCLUDE_UNORDERED_SET
 
@@ -382,6 +383,7 @@ public:
     virtual void visit(AstCoverDecl* nodep) VL_OVERRIDE {
         puts("__vlCoverInsert(");  // As Declared in emitCoverageDecl
         puts("&(vlSymsp->__Vcoverage[");
+        if (v3Global.opt.threads()) puts("0][");  // First thread's shard
         puts(cvtToStr(nodep->dataDeclThisp()->binNum()));
         puts("])");
         // If this isn't the first instantiation of this module under this
@@ -406,10 +408,16 @@ public:
         puts(");\n");
     }
     virtual void visit(AstCoverInc* nodep) VL_OVERRIDE {
-        if (v3Global.opt.threads()) {
-            puts("vlSymsp->__Vcoverage[");
+        if (v3Global.opt.mtasks()) {
+            // Each mtask thread has its own shard, see emitMTaskBody.
+            // __Vcoverp is looked up once per function, see visit(AstCFunc)
+            puts("++(__Vcoverp[");
+            puts(cvtToStr(nodep->declp()->dataDeclThisp()->binNum()));
+            puts("]);\n");
+        } else if (v3Global.opt.threads()) {
+            puts("++(vlSymsp->__Vcoverage[0][");
             puts(cvtToStr(nodep->declp()->dataDeclThisp()->binNum()));
-            puts("].fetch_add(1, std::memory_order_relaxed);\n");
+            puts("]);\n");
         } else {
             puts("++(vlSymsp->__Vcoverage[");
             puts(cvtToStr(nodep->declp()->dataDeclThisp()->binNum()));
@@ -717,7 +725,89 @@ public:
         iterateAndNextNull(nodep->precondsp());  // Need to recompute before next loop
         puts("}\n");
     }
+    bool switchCondValues(AstNode* condp, AstNode*& exprpr, std::vector<uint32_t>& valuesr) {
+        // Gather constants from a condition (expr == const) [|| (expr == const) ...]
+        // where each expr is the same as exprpr (or sets it if NULL)
+        if (VN_IS(condp, LogOr) || VN_IS(condp, Or)) {
+            AstNodeBiop* orp = VN_CAST(condp, NodeBiop);
+            return (switchCondValues(orp->lhsp(), exprpr, valuesr)
+                    && switchCondValues(orp->rhsp(), exprpr, valuesr));
+        }
+        AstEq* eqp = VN_CAST(condp, Eq);
+        if (!eqp) return false;
+        AstConst* constp = VN_CAST(eqp->lhsp(), Const);
+        AstNode* cmpp = eqp->rhsp();
+        if (!constp) {
+            constp = VN_CAST(eqp->rhsp(), Const);
+            cmpp = eqp->lhsp();
+        }
+        if (!constp || VN_IS(cmpp, Const) || constp->num().isFourState()) return false;
+        if (!exprpr) {
+            if (!AstIf::switchableExpr(cmpp)) return false;
+            exprpr = cmpp;
+        } else if (!cmpp->sameTree(exprpr)) {
+            return false;
+        }
+        valuesr.push_back(constp->toUInt());
+        return true;
+    }
+    bool emitSwitch(AstIf* nodep) {
+        // Emit an if/else-if chain V3Case made from a dense case as a
+        // switch; compilers turn dense switches into a jump table.  Other
+        // passes may have changed the chain since, so stop at the first
+        // link that is no longer a simple compare, or that has a branch
+        // hint a switch would lose, and emit the rest as the default.
+        if (!nodep->caseSwitch()) return false;
+        typedef std::vector<uint32_t> Values;
+        typedef std::vector<std::pair<AstIf*, Values> > Arms;
+        AstNode* exprp = NULL;
+        Arms arms;
+        std::set<uint32_t> seen;
+        for (AstIf* ifp = nodep; ifp;) {
+            if (!ifp->caseSwitch() || !ifp->branchPred().unknown()) break;
+            Values values;
+            AstNode* armExprp = exprp;
+            if (!switchCondValues(ifp->condp(), armExprp, values /*ref*/)) break;
+            // A value repeated from an earlier arm can't reach this arm;
+            // leave this arm and the rest as the default
+            bool dup = false;
+            for (Values::iterator it = values.begin(); it != values.end(); ++it) {
+                if (seen.find(*it) != seen.end()) dup = true;
+            }
+            if (dup) break;
+            std::set<uint32_t> armSeen(values.begin(), values.end());
+            seen.insert(armSeen.begin(), armSeen.end());
+            exprp = armExprp;
+            arms.push_back(make_pair(ifp, Values(armSeen.begin(), armSeen.end())));
+            AstIf* nextp = VN_CAST(ifp->elsesp(), If);
+            ifp = (nextp && !nextp->nextp()) ? nextp : NULL;
+        }
+        if (arms.empty()) return false;
+
+        puts("switch (");
+        iterateAndNextNull(exprp);
+        puts(") {\n");
+        for (Arms::iterator it = arms.begin(); it != arms.end(); ++it) {
+            for (Values::iterator vit = it->second.begin(); vit != it->second.end(); ++vit) {
+                puts("case " + cvtToStr(*vit) + "U:\n");
+            }
+            puts("{\n");
+            iterateAndNextNull(it->first->ifsp());
+            puts("}\n");
+            puts("break;\n");
+        }
+        if (AstNode* defaultp = arms.back().first->elsesp()) {
+            puts("default: {\n");
+            iterateAndNextNull(defaultp);
+            puts("}\n");
+        }
+        puts("}\n");
+        return true;
+    }
     virtual void visit(AstNodeIf* nodep) VL_OVERRIDE {
+        if (AstIf* ifp = VN_CAST(nodep, If)) {
+            if (emitSwitch(ifp)) return;
+        }
         puts("if (");
         if (!nodep->branchPred().unknown()) {
             puts(nodep->branchPred().ascii());
@@ -1220,6 +1310,30 @@ public:
 
 unsigned EmitVarTspSorter::m_serialNext = 0;
 
+//######################################################################
+// Find if a function increments coverage points, so it needs this
+// thread's coverage counters
+
+class EmitCoverIncVisitor : public AstNVisitor {
+private:
+    // STATE
+    bool m_found;  // Found an AstCoverInc
+    // VISITORS
+    virtual void visit(AstCoverInc* nodep) VL_OVERRIDE { m_found = true; }
+    virtual void visit(AstNode* nodep) VL_OVERRIDE {
+        if (!m_found) iterateChildren(nodep);
+    }
+
+public:
+    // CONSTRUCTORS
+    explicit EmitCoverIncVisitor(AstCFunc* nodep)
+        : m_found(false) {
+        iterateChildren(nodep);
+    }
+    virtual ~EmitCoverIncVisitor() {}
+    bool found() const { return m_found; }
+};
+
 //######################################################################
 // Internal EmitC implementation
 
@@ -1349,6 +1463,11 @@ class EmitCImp : EmitCStmts {
             puts("}\n");
         }
         puts("Verilated::mtaskId(" + cvtToStr(curExecMTaskp->id()) + ");\n");
+        if (v3Global.opt.coverage()) {
+            // Selects this thread's coverage counters; only one OS thread
+            // runs each static thread's mtasks, so the counters need no atomics
+            puts("Verilated::threadNum(" + cvtToStr(curExecMTaskp->thread()) + ");\n");
+        }
 
         // The actual body of calls to leaf functions
         iterateAndNextNull(nodep->stmtsp());
@@ -1434,6 +1553,12 @@ class EmitCImp : EmitCStmts {
         // Declare and set vlTOPp
         if (nodep->symProlog()) puts(EmitCBaseVisitor::symTopAssign() + "\n");
 
+        if (v3Global.opt.mtasks() && EmitCoverIncVisitor(nodep).found()) {
+            // This thread's coverage counters, used by each AstCoverInc.
+            // Verilated::threadNum is thread local, so only read it once.
+            puts("uint32_t* const __Vcoverp = vlSymsp->__Vcoverage[Verilated::threadNum()];\n");
+        }
+
         if (nodep->initsp()) putsDecoration("// Variables\n");
         for (AstNode* subnodep = nodep->argsp(); subnodep; subnodep = subnodep->nextp()) {
             if (AstVar* varp = VN_CAST(subnodep, Var)) {
@@ -1543,6 +1668,7 @@ class EmitCImp : EmitCStmts {
                     puts(protect(execMTasks[i]->cFuncName())
                          + "(vlTOPp->__Vm_even_cycle, vlSymsp);\n");
                     puts("Verilated::mtaskId(0);\n");
+                    if (v3Global.opt.coverage()) puts("Verilated::threadNum(0);\n");
                 } else {
                     // The other N-1 go to the thread pool.
                     puts("vlTOPp->__Vm_threadPoolp->workerp(" + cvtToStr(i) + ")->addTask("
@@ -1690,6 +1816,8 @@ class EmitCImp : EmitCStmts {
     void emitCoverageDecl(AstNodeModule* modp);
     void emitCoverageImp(AstNodeModule* modp);
     void emitDestructorImp(AstNodeModule* modp);
+    bool savableSkip(const AstNodeModule* modp, const AstVar* varp);
+    static bool savableBulk(const AstVar* varp);
     void emitSavableImp(AstNodeModule* modp);
     void emitTextSection(AstType type);
     // High level
@@ -2179,8 +2307,7 @@ void EmitCImp::emitCoverageDecl(AstNodeModule* modp) {
         ofp()->putsPrivate(true);
         putsDecoration("// Coverage\n");
         puts("void __vlCoverInsert(");
-        puts(v3Global.opt.threads() ? "std::atomic<uint32_t>" : "uint32_t");
-        puts("* countp, bool enable, const char* filenamep, int lineno, int column,\n");
+        puts("uint32_t* countp, bool enable, const char* filenamep, int lineno, int column,\n");
         puts("const char* hierp, const char* pagep, const char* commentp);\n");
     }
 }
@@ -2302,21 +2429,26 @@ void EmitCImp::emitCoverageImp(AstNodeModule* modp) {
         // Rather than putting out VL_COVER_INSERT calls directly, we do it via this function
         // This gets around gcc slowness constructing all of the template arguments.
         puts("void " + prefixNameProtect(m_modp) + "::__vlCoverInsert(");
-        puts(v3Global.opt.threads() ? "std::atomic<uint32_t>" : "uint32_t");
-        puts("* countp, bool enable, const char* filenamep, int lineno, int column,\n");
+        puts("uint32_t* countp, bool enable, const char* filenamep, int lineno, int column,\n");
         puts("const char* hierp, const char* pagep, const char* commentp) {\n");
+        puts("uint32_t* count32p = countp;\n");
+        // static doesn't need save-restore as is constant
+        puts("static uint32_t fake_zero_count = 0;\n");
         if (v3Global.opt.threads()) {
-            puts("assert(sizeof(uint32_t) == sizeof(std::atomic<uint32_t>));\n");
-            puts("uint32_t* count32p = reinterpret_cast<uint32_t*>(countp);\n");
+            // Counted in a shard per thread, see __Vcoverage in the symbol table
+            puts("int shards = sizeof(__VlSymsp->__Vcoverage)"
+                 " / sizeof(__VlSymsp->__Vcoverage[0]);\n");
+            // Used for second++ instantiation of identical bin
+            puts("if (!enable) { count32p = &fake_zero_count; shards = 1; }\n");
+            puts("*count32p = 0;\n");
+            puts("VL_COVER_INSERT_SHARDS(count32p, shards,");
+            puts(" sizeof(__VlSymsp->__Vcoverage[0]) / sizeof(uint32_t),");
         } else {
-            puts("uint32_t* count32p = countp;\n");
+            // Used for second++ instantiation of identical bin
+            puts("if (!enable) count32p = &fake_zero_count;\n");
+            puts("*count32p = 0;\n");
+            puts("VL_COVER_INSERT(count32p,");
         }
-        // static doesn't need save-restore as is constant
-        puts("static uint32_t fake_zero_count = 0;\n");
-        // Used for second++ instantiation of identical bin
-        puts("if (!enable) count32p = &fake_zero_count;\n");
-        puts("*count32p = 0;\n");
-        puts("VL_COVER_INSERT(count32p,");
         puts("  \"filename\",filenamep,");
         puts("  \"lineno\",lineno,");
         puts("  \"column\",column,\n");
@@ -2348,6 +2480,29 @@ void EmitCImp::emitDestructorImp(AstNodeModule* modp) {
     splitSizeInc(10);
 }
 
+bool EmitCImp::savableSkip(const AstNodeModule* modp, const AstVar* varp) {
+    // Return if the variable is not part of the saved model state
+    if (varp->isIO() && modp->isTop() && optSystemC()) {
+        // System C top I/O doesn't need loading, as the
+        // lower level subinst code does it.
+        return true;
+    }
+    return varp->isParam() || (varp->isStatic() && varp->isConst());
+}
+
+bool EmitCImp::savableBulk(const AstVar* varp) {
+    // Return if the variable is an unpacked or wide array of plain data,
+    // which can be saved and restored as a single block
+    AstNodeDType* elementp = varp->dtypeSkipRefp();
+    bool arrayed = elementp->isWide();
+    while (AstUnpackArrayDType* arrayp = VN_CAST(elementp, UnpackArrayDType)) {
+        elementp = arrayp->subDTypep()->skipRefp();
+        arrayed = true;
+    }
+    AstBasicDType* basicp = elementp->basicp();
+    return arrayed && basicp && !basicp->isString();
+}
+
 void EmitCImp::emitSavableImp(AstNodeModule* modp) {
     if (v3Global.opt.savable()) {
         puts("\n// Savable\n");
@@ -2380,11 +2535,12 @@ void EmitCImp::emitSavableImp(AstNodeModule* modp) {
             if (v3Global.opt.inhibitSim()) puts("os" + op + "__Vm_inhibitSim;\n");
             for (AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
                 if (const AstVar* varp = VN_CAST(nodep, Var)) {
-                    if (varp->isIO() && modp->isTop() && optSystemC()) {
-                        // System C top I/O doesn't need loading, as the
-                        // lower level subinst code does it.
-                    } else if (varp->isParam()) {
-                    } else if (varp->isStatic() && varp->isConst()) {
+                    if (savableSkip(modp, varp)) {
+                    } else if (savableBulk(varp)) {
+                        // Contiguous plain data; the same bytes as the element loop below
+                        // NOLINTNEXTLINE(performance-inefficient-string-concatenation)
+                        puts(string("os.") + (de ? "read" : "write") + "(&" + varp->nameProtect()
+                             + ", sizeof(" + varp->nameProtect() + "));\n");
                     } else {
                         int vects = 0;
                         AstNodeDType* elementp = varp->dtypeSkipRefp();
@@ -2425,6 +2581,38 @@ void EmitCImp::emitSavableImp(AstNodeModule* modp) {
             }
             puts("}\n");
         }
+
+        // Copy the same state directly from another instance
+        puts("void " + prefixNameProtect(modp) + "::" + protect("__VcloneState") + "(const "
+             + prefixNameProtect(modp) + "& rhs) {\n");
+        if (v3Global.opt.inhibitSim()) puts("__Vm_inhibitSim = rhs.__Vm_inhibitSim;\n");
+        for (AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            if (const AstVar* varp = VN_CAST(nodep, Var)) {
+                const string name = varp->nameProtect();
+                if (savableSkip(modp, varp)) {
+                } else if (savableBulk(varp)) {
+                    puts("memcpy(&" + name + ", &rhs." + name + ", sizeof(" + name + "));\n");
+                } else {
+                    // Arrays of strings etc. need each element assigned
+                    int vects = 0;
+                    AstNodeDType* elementp = varp->dtypeSkipRefp();
+                    for (AstUnpackArrayDType* arrayp = VN_CAST(elementp, UnpackArrayDType);
+                         arrayp; arrayp = VN_CAST(elementp, UnpackArrayDType)) {
+                        string ivar = string("__Vi") + cvtToStr(vects++);
+                        puts("for (int " + ivar + " = 0; " + ivar + " < "
+                             + cvtToStr(arrayp->elementsConst()) + "; ++" + ivar + ") ");
+                        elementp = arrayp->subDTypep()->skipRefp();
+                    }
+                    string indices;
+                    for (int v = 0; v < vects; ++v) indices += "[__Vi" + cvtToStr(v) + "]";
+                    puts(name + indices + " = rhs." + name + indices + ";\n");
+                }
+            }
+        }
+        if (modp->isTop()) {  // Clone the children
+            puts("__VlSymsp->" + protect("__VcloneState") + "(*rhs.__VlSymsp);\n");
+        }
+        puts("}\n");
     }
 }
 
@@ -2641,9 +2829,15 @@ void EmitCStmts::emitVarList(AstNode* firstp, EisWhich which, const string& pref
     // on successive Mtask groups, but then when a new mtask gets added may
     // cause a huge delta.
     //
+    // Within each list, variables --var-feedback measured as rarely
+    // accessed are put after the rest, so the state touched every cycle is
+    // contiguous and needs fewer cache lines.  Ports keep their order.
+    //
     // TODO: Move this sort to an earlier visitor stage.
     VarSortMap varAnonMap;
     VarSortMap varNonanonMap;
+    VarSortMap varAnonColdMap;
+    VarSortMap varNonanonColdMap;
 
     for (int isstatic = 1; isstatic >= 0; isstatic--) {
         if (prefixIfImp != "" && !isstatic) continue;
@@ -2691,17 +2885,21 @@ void EmitCStmts::emitVarList(AstNode* firstp, EisWhich which, const string& pref
                                        && !varp->basicp()->isOpaque())  // Aggregates can't be anon
                                    && which != EVL_FUNC_ALL);  // Anon not legal in funcs, and gcc
                                                                // bug free there anyhow
+                    // Clocks stay hot; ports keep their declared order
+                    bool cold = (varp->profCold() && which != EVL_CLASS_IO
+                                 && which != EVL_FUNC_ALL && sortbytes != 0);
                     if (anonOk) {
-                        varAnonMap[sortbytes].push_back(varp);
+                        (cold ? varAnonColdMap : varAnonMap)[sortbytes].push_back(varp);
                     } else {
-                        varNonanonMap[sortbytes].push_back(varp);
+                        (cold ? varNonanonColdMap : varNonanonMap)[sortbytes].push_back(varp);
                     }
                 }
             }
         }
     }
 
-    if (!varAnonMap.empty() || !varNonanonMap.empty()) {
+    if (!varAnonMap.empty() || !varNonanonMap.empty() || !varAnonColdMap.empty()
+        || !varNonanonColdMap.empty()) {
         if (!sectionr.empty()) {
             puts(sectionr);
             sectionr = "";
@@ -2711,6 +2909,16 @@ void EmitCStmts::emitVarList(AstNode* firstp, EisWhich which, const string& pref
         emitVarSort(varAnonMap, &anons);
         emitVarSort(varNonanonMap, &nonanons);
         emitSortedVarList(anons, nonanons, prefixIfImp);
+        if (!varAnonColdMap.empty() || !varNonanonColdMap.empty()) {
+            VarVec coldAnons;
+            VarVec coldNonanons;
+            emitVarSort(varAnonColdMap, &coldAnons);
+            emitVarSort(varNonanonColdMap, &coldNonanons);
+            if (!anons.empty() || !nonanons.empty()) {
+                putsDecoration("// Rarely accessed, per --var-feedback\n");
+            }
+            emitSortedVarList(coldAnons, coldNonanons, prefixIfImp);
+        }
     }
 }
 
@@ -3074,6 +3282,12 @@ void EmitCImp::emitInt(AstNodeModule* modp) {
             puts("/// Disable evaluation of module (e.g. turn off)\n");
             puts("void inhibitSim(bool flag) { __Vm_inhibitSim = flag; }\n");
         }
+        if (v3Global.opt.savable()) {
+            puts("/// Copy all model state from another instance of this model,\n");
+            puts("/// e.g. to start many runs from one point without a save file.\n");
+            puts("void cloneStateFrom(const " + prefixNameProtect(modp)
+                 + "& rhs) { Verilated::quiesce(); " + protect("__VcloneState") + "(rhs); }\n");
+        }
     }
 
     puts("\n// INTERNAL METHODS\n");
@@ -3109,6 +3323,8 @@ void EmitCImp::emitInt(AstNodeModule* modp) {
         ofp()->putsPrivate(false);  // public:
         puts("void " + protect("__Vserialize") + "(VerilatedSerialize& os);\n");
         puts("void " + protect("__Vdeserialize") + "(VerilatedDeserialize& os);\n");
+        puts("void " + protect("__VcloneState") + "(const " + prefixNameProtect(modp)
+             + "& rhs);\n");
     }
 
     puts("}");
@@ -3386,6 +3602,23 @@ class EmitCTrace : EmitCStmts {
         puts("\n//======================\n\n");
     }
 
+    bool emitTraceChunks(AstCFunc* nodep) {
+        // If V3Trace split the change function into chunks, run them in parallel
+        const AstCCall* callp = VN_CAST(nodep->stmtsp(), CCall);
+        if (!callp || callp->funcp()->funcType() != AstCFuncType::TRACE_CHANGE_CHUNK) {
+            return false;
+        }
+        int chunks = 0;
+        puts("static const " + v3Global.opt.traceClassBase() + "Callback_t chunks[] = {\n");
+        for (; callp; callp = VN_CAST(callp->nextp(), CCall), ++chunks) {
+            puts("&" + topClassName() + "::" + callp->funcp()->nameProtect() + ",\n");
+        }
+        puts("};\n");
+        puts("vcdp->chgParallel(vlTOPp->__Vm_threadPoolp, " + cvtToStr(chunks)
+             + ", chunks, vlTOPp, code);\n");
+        return true;
+    }
+
     bool emitTraceIsScBv(AstTraceInc* nodep) {
         const AstVarRef* varrefp = VN_CAST(nodep->valuep(), VarRef);
         if (!varrefp) return false;
@@ -3566,7 +3799,9 @@ class EmitCTrace : EmitCStmts {
 
         const uint32_t offset = (arrayindex < 0) ? 0 : (arrayindex * nodep->declp()->widthWords());
         const uint32_t code = nodep->declp()->code() + offset;
-        puts("(oldp+" + cvtToStr(code - m_baseCode) + ",");
+        puts("(oldp+" + cvtToStr(code - m_baseCode));
+        if (arrayindex == -2) puts("+i*" + cvtToStr(nodep->declp()->widthWords()));
+        puts(",");
         emitTraceValue(nodep, arrayindex);
         if (emitWidth) puts("," + cvtToStr(nodep->declp()->widthMin()));
         puts(");\n");
@@ -3634,6 +3869,11 @@ class EmitCTrace : EmitCStmts {
             puts(" ");
             puts(topClassName() + "::" + nodep->nameProtect() + "(" + cFuncArgs(nodep) + ") {\n");
 
+            if (nodep->funcType() == AstCFuncType::TRACE_CHANGE_CHUNK) {
+                puts(EmitCBaseVisitor::symClassVar() + " = static_cast<" + topClassName()
+                     + "*>(userthis)->__VlSymsp;\n");
+                puts(EmitCBaseVisitor::symTopAssign() + "\n");
+            }
             if (nodep->symProlog()) puts(EmitCBaseVisitor::symTopAssign() + "\n");
 
             m_baseCode = -1;
@@ -3645,6 +3885,22 @@ class EmitCTrace : EmitCStmts {
                     nodep->stmtsp()->v3fatalSrc("Trace sub function should contain AstTraceInc");
                 }
                 m_baseCode = stmtp->declp()->code();
+                // Skip the whole function if traceExclude/traceInclude disabled its signals
+                uint32_t endCode = m_baseCode;
+                int incs = 0;
+                for (const AstNode* subp = stmtp; subp; subp = subp->nextp()) {
+                    if (const AstTraceInc* const incp = VN_CAST_CONST(subp, TraceInc)) {
+                        endCode = std::max(endCode, incp->declp()->code()
+                                                        + incp->declp()->codeInc());
+                        ++incs;
+                    }
+                }
+                puts("if (VL_UNLIKELY(!vcdp->isEnabledRange(code+" + cvtToStr(m_baseCode)
+                     + ", code+" + cvtToStr(endCode) + "))) return;\n");
+                if (v3Global.opt.traceFineActivity()
+                    && nodep->funcType() == AstCFuncType::TRACE_CHANGE_SUB) {
+                    puts("vcdp->statCheckedInc(" + cvtToStr(incs) + ");\n");
+                }
                 puts("vluint32_t* oldp = vcdp->oldp(code+" + cvtToStr(m_baseCode) + ");\n");
                 puts("if (false && vcdp && oldp) {}  // Prevent unused\n");
             } else if (nodep->funcType() == AstCFuncType::TRACE_INIT_SUB) {
@@ -3661,6 +3917,7 @@ class EmitCTrace : EmitCStmts {
             } else if (nodep->funcType() == AstCFuncType::TRACE_FULL_SUB) {
             } else if (nodep->funcType() == AstCFuncType::TRACE_CHANGE) {
             } else if (nodep->funcType() == AstCFuncType::TRACE_CHANGE_SUB) {
+            } else if (nodep->funcType() == AstCFuncType::TRACE_CHANGE_CHUNK) {
             } else {
                 nodep->v3fatalSrc("Bad Case");
             }
@@ -3675,7 +3932,7 @@ class EmitCTrace : EmitCStmts {
             if (nodep->stmtsp()) {
                 putsDecoration("// Body\n");
                 puts("{\n");
-                iterateAndNextNull(nodep->stmtsp());
+                if (!emitTraceChunks(nodep)) iterateAndNextNull(nodep->stmtsp());
                 puts("}\n");
             }
             if (nodep->finalsp()) {
@@ -3697,8 +3954,49 @@ class EmitCTrace : EmitCStmts {
             puts("\n");
         }
     }
+    void emitTraceWrites(AstTraceInc* nodep) {
+        // --trace-array-writes; loop rather than unroll, as may be large
+        const int elements = nodep->declp()->arrayRange().elements();
+        if (m_funcp->funcType() == AstCFuncType::TRACE_FULL
+            || m_funcp->funcType() == AstCFuncType::TRACE_FULL_SUB) {
+            puts("for (int i = 0; i < " + cvtToStr(elements) + "; ++i) {\n");
+            emitTraceChangeOne(nodep, -2);
+            puts("}\n");
+            return;
+        }
+        // Only check elements flagged as written, a block at a time
+        const int blockSize = 64;  // Must match V3Trace's TRACE_WRITES_BLOCK_SHIFT
+        const int blocks = (elements + blockSize - 1) / blockSize;
+        puts("{\n");
+        puts("const bool all = ");
+        iterate(nodep->writeBlocksp());
+        puts("[" + cvtToStr(blocks) + "];\n");
+        iterate(nodep->writeBlocksp());
+        puts("[" + cvtToStr(blocks) + "] = 0;\n");
+        puts("for (int b = 0; b < " + cvtToStr(blocks) + "; ++b) {\n");
+        puts("if (VL_LIKELY(!all && !");
+        iterate(nodep->writeBlocksp());
+        puts("[b])) continue;\n");
+        iterate(nodep->writeBlocksp());
+        puts("[b] = 0;\n");
+        puts("const int e = (b == " + cvtToStr(blocks - 1) + ") ? " + cvtToStr(elements)
+             + " : (b + 1) * " + cvtToStr(blockSize) + ";\n");
+        puts("for (int i = b * " + cvtToStr(blockSize) + "; i < e; ++i) {\n");
+        puts("if (!all && !");
+        iterate(nodep->writesp());
+        puts("[i]) continue;\n");
+        iterate(nodep->writesp());
+        puts("[i] = 0;\n");
+        emitTraceChangeOne(nodep, -2);
+        puts("}\n");
+        puts("}\n");
+        puts("}\n");
+    }
+
     virtual void visit(AstTraceInc* nodep) VL_OVERRIDE {
-        if (nodep->declp()->arrayRange().ranged()) {
+        if (nodep->writesp()) {
+            emitTraceWrites(nodep);
+        } else if (nodep->declp()->arrayRange().ranged()) {
             // It traces faster if we unroll the loop
             for (int i = 0; i < nodep->declp()->arrayRange().elements(); i++) {
                 emitTraceChangeOne(nodep, i);
@@ -114,15 +114,21 @@ class CMakeEmitter {
         cmake_set_raw(*of, name + "_THREADS", cvtToStr(v3Global.opt.threads()));
         *of << "# VCD Tracing output mode?  0/1 (from --trace)\n";
         cmake_set_raw(*of, name + "_TRACE_VCD",
-                      (v3Global.opt.trace() && (v3Global.opt.traceFormat() == TraceFormat::VCD))
+                      (v3Global.opt.trace() && !v3Global.opt.traceFormat().fstFlavor())
                           ? "1"
                           : "0");
         *of << "# FST Tracing output mode? 0/1 (from --fst-trace)\n";
         cmake_set_raw(*of, name + "_TRACE_FST",
-                      (v3Global.opt.trace() && (v3Global.opt.traceFormat() != TraceFormat::VCD))
+                      (v3Global.opt.trace() && v3Global.opt.traceFormat().fstFlavor())
                           ? "1"
                           : "0");
 
+        *of << "# Compressed VCD tracing output mode?  0/1 (from --trace-gz)\n";
+        cmake_set_raw(*of, name + "_TRACE_GZ", v3Global.opt.traceGz() ? "1" : "0");
+        *of << "# Tracing statistics?  0/1 (from --trace-fine-activity)\n";
+        cmake_set_raw(*of, name + "_TRACE_STATS",
+                      v3Global.opt.traceFineActivity() ? "1" : "0");
+
         *of << "\n### Sources...\n";
         std::vector<string> classes_fast, classes_slow, support_fast, support_slow, global;
         for (AstNodeFile* nodep = v3Global.rootp()->filesp(); nodep;
@@ -162,7 +168,7 @@ class CMakeEmitter {
             global.push_back("${VERILATOR_ROOT}/include/" + v3Global.opt.traceSourceBase()
                              + "_c.cpp");
             if (v3Global.opt.systemC()) {
-                if (v3Global.opt.traceFormat() != TraceFormat::VCD) {
+                if (v3Global.opt.traceFormat().fstFlavor()) {
                     v3error("Unsupported: This trace format is not supported in SystemC, "
                             "use VCD format.");
                 }
@@ -461,10 +461,18 @@ void EmitCSyms::emitSymHdr() {
 
     if (m_coverBins) {
         puts("\n// COVERAGE\n");
-        puts(v3Global.opt.threads() ? "std::atomic<uint32_t>" : "uint32_t");
-        puts(" __Vcoverage[");
-        puts(cvtToStr(m_coverBins));
-        puts("];\n");
+        if (v3Global.opt.threads()) {
+            // A row of counters for each mtask thread, so threads never
+            // share a counter's cache line, nor need atomic increments
+            const int lineBins = VL_CACHE_LINE_BYTES / sizeof(uint32_t);
+            const int rowBins = (m_coverBins + lineBins - 1) / lineBins * lineBins;
+            puts("uint32_t __Vcoverage[" + cvtToStr(v3Global.opt.threads()) + "]["
+                 + cvtToStr(rowBins) + "] VL_ATTR_ALIGNED(VL_CACHE_LINE_BYTES);\n");
+        } else {
+            puts("uint32_t __Vcoverage[");
+            puts(cvtToStr(m_coverBins));
+            puts("];\n");
+        }
     }
 
     if (!m_scopeNames.empty()) {  // Scope names
@@ -502,6 +510,7 @@ void EmitCSyms::emitSymHdr() {
     if (v3Global.opt.savable()) {
         puts("void " + protect("__Vserialize") + "(VerilatedSerialize& os);\n");
         puts("void " + protect("__Vdeserialize") + "(VerilatedDeserialize& os);\n");
+        puts("void " + protect("__VcloneState") + "(const " + symClassName() + "& rhs);\n");
     }
     puts("\n");
     puts("} VL_ATTR_ALIGNED(VL_CACHE_LINE_BYTES);\n");
@@ -614,6 +623,22 @@ void EmitCSyms::emitSymImp() {
             }
             puts("}\n");
         }
+        puts("void " + symClassName() + "::" + protect("__VcloneState") + "(const "
+             + symClassName() + "& rhs) {\n");
+        puts("// LOCAL STATE\n");
+        if (v3Global.opt.trace()) puts("__Vm_activity = rhs.__Vm_activity;\n");
+        puts("__Vm_didInit = rhs.__Vm_didInit;\n");
+        puts("// SUBCELL STATE\n");
+        for (std::vector<ScopeModPair>::iterator it = m_scopes.begin(); it != m_scopes.end();
+             ++it) {
+            AstScope* scopep = it->first;
+            AstNodeModule* modp = it->second;
+            if (!modp->isTop()) {
+                const string name = protectIf(scopep->nameDotless(), scopep->protect());
+                puts(name + "." + protect("__VcloneState") + "(rhs." + name + ");\n");
+            }
+        }
+        puts("}\n");
     }
 
     puts("\n");
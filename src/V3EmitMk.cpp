@@ -64,10 +64,18 @@ public:
         of.puts("VM_TRACE = ");
         of.puts(v3Global.opt.trace() ? "1" : "0");
         of.puts("\n");
-        of.puts("# Tracing threaded output mode?  0/1 (from --trace-fst-thread)\n");
+        of.puts("# Tracing threaded output mode?  0/1 (from --trace-fst-thread/--trace-thread)\n");
         of.puts("VM_TRACE_THREADED = ");
         of.puts(v3Global.opt.traceFormat().threaded() ? "1" : "0");
         of.puts("\n");
+        of.puts("# Tracing compressed VCD output mode?  0/1 (from --trace-gz)\n");
+        of.puts("VM_TRACE_GZ = ");
+        of.puts(v3Global.opt.traceGz() ? "1" : "0");
+        of.puts("\n");
+        of.puts("# Tracing statistics?  0/1 (from --trace-fine-activity)\n");
+        of.puts("VM_TRACE_STATS = ");
+        of.puts(v3Global.opt.traceFineActivity() ? "1" : "0");
+        of.puts("\n");
 
         of.puts("\n### Object file lists...\n");
         for (int support = 0; support < 3; ++support) {
@@ -96,7 +104,7 @@ public:
                     if (v3Global.opt.trace()) {
                         putMakeClassEntry(of, v3Global.opt.traceSourceBase() + "_c.cpp");
                         if (v3Global.opt.systemC()) {
-                            if (v3Global.opt.traceFormat() != TraceFormat::VCD) {
+                            if (v3Global.opt.traceFormat().fstFlavor()) {
                                 v3error("Unsupported: This trace format is not supported "
                                         "in SystemC, use VCD format.");
                             } else {
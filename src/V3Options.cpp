@@ -853,9 +853,11 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
             else if ( onoff (sw, "-pins-uint8", flag/*ref*/))   { m_pinsUint8 = flag; }
             else if ( onoff (sw, "-pp-comments", flag/*ref*/))  { m_ppComments = flag; }
             else if (!strcmp(sw, "-private"))                   { m_public = false; }
+            else if ( onoff (sw, "-prof-branches", flag/*ref*/))     { m_profBranches = flag; }
             else if ( onoff (sw, "-prof-cfuncs", flag/*ref*/))       { m_profCFuncs = flag; }
             else if ( onoff (sw, "-profile-cfuncs", flag/*ref*/))    { m_profCFuncs = flag; }  // Undocumented, for backward compat
             else if ( onoff (sw, "-prof-threads", flag/*ref*/))      { m_profThreads = flag; }
+            else if ( onoff (sw, "-prof-vars", flag/*ref*/))         { m_profVars = flag; }
             else if ( onoff (sw, "-protect-ids", flag/*ref*/))       { m_protectIds = flag; }
             else if ( onoff (sw, "-public", flag/*ref*/))            { m_public = flag; }
             else if ( onoff (sw, "-public-flat-rw", flag/*ref*/) )   { m_publicFlatRW = flag; v3Global.dpi(true); }
@@ -873,8 +875,10 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
             else if (!strcmp(sw, "-sv"))                             { m_defaultLanguage = V3LangCode::L1800_2005; }
             else if ( onoff (sw, "-threads-coarsen", flag/*ref*/))   { m_threadsCoarsen = flag; }  // Undocumented, debug
             else if ( onoff (sw, "-trace", flag/*ref*/))             { m_trace = flag; }
+            else if ( onoff (sw, "-trace-array-writes", flag/*ref*/)) { m_traceArrayWrites = flag; }
             else if ( onoff (sw, "-trace-coverage", flag/*ref*/))    { m_traceCoverage = flag; }
             else if ( onoff (sw, "-trace-dups", flag/*ref*/))        { m_traceDups = flag; }
+            else if ( onoff (sw, "-trace-fine-activity", flag/*ref*/)) { m_traceFineActivity = flag; }
             else if ( onoff (sw, "-trace-params", flag/*ref*/))      { m_traceParams = flag; }
             else if ( onoff (sw, "-trace-structs", flag/*ref*/))     { m_traceStructs = flag; }
             else if ( onoff (sw, "-trace-underscore", flag/*ref*/))  { m_traceUnderscore = flag; }
@@ -1063,6 +1067,15 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
                 m_trace = true;
                 m_traceFormat = TraceFormat::FST_THREAD;
                 addLdLibs("-lz");
+            } else if (!strcmp(sw, "-trace-thread")) {
+                m_trace = true;
+                m_traceFormat = TraceFormat::VCD_THREAD;
+            } else if (!strcmp(sw, "-trace-gz")) {
+                // Compression is slow, so is done on the writer thread
+                m_trace = true;
+                m_traceFormat = TraceFormat::VCD_THREAD;
+                m_traceGz = true;
+                addLdLibs("-lz");
             } else if (!strcmp(sw, "-trace-depth") && (i + 1) < argc) {
                 shift;
                 m_traceDepth = atoi(argv[i]);
@@ -1144,6 +1157,9 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
             } else if (!strcmp(sw, "-bin") && (i + 1) < argc) {
                 shift;
                 m_bin = argv[i];
+            } else if (!strcmp(sw, "-branch-feedback") && (i + 1) < argc) {
+                shift;
+                m_branchFeedback = argv[i];
             } else if (!strcmp(sw, "-compiler") && (i + 1) < argc) {
                 shift;
                 if (!strcmp(argv[i], "clang")) {
@@ -1243,6 +1259,9 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
             } else if (!strcmp(sw, "-unused-regexp") && (i + 1) < argc) {
                 shift;
                 m_unusedRegexp = argv[i];
+            } else if (!strcmp(sw, "-var-feedback") && (i + 1) < argc) {
+                shift;
+                m_varFeedback = argv[i];
             } else if (!strcmp(sw, "-x-assign") && (i + 1) < argc) {
                 shift;
                 if (!strcmp(argv[i], "0")) {
@@ -1538,8 +1557,10 @@ V3Options::V3Options() {
     m_pinsScBigUint = false;
     m_pinsUint8 = false;
     m_ppComments = false;
+    m_profBranches = false;
     m_profCFuncs = false;
     m_profThreads = false;
+    m_profVars = false;
     m_protectIds = false;
     m_preprocOnly = false;
     m_preprocNoLine = false;
@@ -1560,9 +1581,12 @@ V3Options::V3Options() {
     m_threadsCoarsen = true;
     m_threadsMaxMTasks = 0;
     m_trace = false;
+    m_traceArrayWrites = false;
     m_traceCoverage = false;
     m_traceDups = false;
+    m_traceFineActivity = false;
     m_traceFormat = TraceFormat::VCD;
+    m_traceGz = false;
     m_traceParams = true;
     m_traceStructs = false;
     m_traceUnderscore = false;
@@ -1595,9 +1619,11 @@ V3Options::V3Options() {
 
     m_makeDir = "obj_dir";
     m_bin = "";
+    m_branchFeedback = "";
     m_flags = "";
     m_l2Name = "";
     m_unusedRegexp = "*unused*";
+    m_varFeedback = "";
     m_xAssign = "fast";
 
     m_defaultLanguage = V3LangCode::mostRecent();
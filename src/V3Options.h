@@ -150,7 +150,7 @@ inline std::ostream& operator<<(std::ostream& os, const VTimescale& rhs) {
 
 class TraceFormat {
 public:
-    enum en { VCD = 0, FST, FST_THREAD } m_e;
+    enum en { VCD = 0, FST, FST_THREAD, VCD_THREAD } m_e;
     // cppcheck-suppress noExplicitConstructor
     inline TraceFormat(en _e = VCD)
         : m_e(_e) {}
@@ -158,13 +158,15 @@ public:
         : m_e(static_cast<en>(_e)) {}
     operator en() const { return m_e; }
     bool fstFlavor() const { return m_e == FST || m_e == FST_THREAD; }
-    bool threaded() const { return m_e == FST_THREAD; }
+    bool threaded() const { return m_e == FST_THREAD || m_e == VCD_THREAD; }
     string classBase() const {
-        static const char* const names[] = {"VerilatedVcd", "VerilatedFst", "VerilatedFst"};
+        static const char* const names[] = {"VerilatedVcd", "VerilatedFst", "VerilatedFst",
+                                             "VerilatedVcd"};
         return names[m_e];
     }
     string sourceName() const {
-        static const char* const names[] = {"verilated_vcd", "verilated_fst", "verilated_fst"};
+        static const char* const names[] = {"verilated_vcd", "verilated_fst", "verilated_fst",
+                                             "verilated_vcd"};
         return names[m_e];
     }
 };
@@ -241,8 +243,10 @@ private:
     bool        m_pinsScBigUint;// main switch: --pins-sc-biguint
     bool        m_pinsUint8;    // main switch: --pins-uint8
     bool        m_ppComments;   // main switch: --pp-comments
+    bool        m_profBranches; // main switch: --prof-branches
     bool        m_profCFuncs;   // main switch: --prof-cfuncs
     bool        m_profThreads;  // main switch: --prof-threads
+    bool        m_profVars;     // main switch: --prof-vars
     bool        m_protectIds;   // main switch: --protect-ids
     bool        m_public;       // main switch: --public
     bool        m_publicFlatRW;  // main switch: --public-flat-rw
@@ -259,8 +263,11 @@ private:
     bool        m_threadsDpiPure;  // main switch: --threads-dpi all/pure
     bool        m_threadsDpiUnpure;  // main switch: --threads-dpi all
     bool        m_trace;        // main switch: --trace
+    bool        m_traceArrayWrites;  // main switch: --trace-array-writes
     bool        m_traceCoverage;  // main switch: --trace-coverage
     bool        m_traceDups;    // main switch: --trace-dups
+    bool        m_traceFineActivity;  // main switch: --trace-fine-activity
+    bool        m_traceGz;      // main switch: --trace-gz
     bool        m_traceParams;  // main switch: --trace-params
     bool        m_traceStructs; // main switch: --trace-structs
     bool        m_traceUnderscore;// main switch: --trace-underscore
@@ -302,6 +309,7 @@ private:
     int         m_compLimitParens;  // compiler selection; number of nested parens
 
     string      m_bin;          // main switch: --bin {binary}
+    string      m_branchFeedback;  // main switch: --branch-feedback {filename}
     string      m_exeName;      // main switch: -o {name}
     string      m_flags;        // main switch: -f {name}
     string      m_l2Name;       // main switch: --l2name; "" for top-module's name
@@ -313,6 +321,7 @@ private:
     string      m_protectLib;   // main switch: --protect-lib {lib_name}
     string      m_topModule;    // main switch: --top-module
     string      m_unusedRegexp; // main switch: --unused-regexp
+    string      m_varFeedback;  // main switch: --var-feedback {filename}
     string      m_xAssign;      // main switch: --x-assign
     string      m_xInitial;     // main switch: --x-initial
     string      m_xmlOutput;    // main switch: --xml-output
@@ -393,6 +402,7 @@ public:
     bool preprocNoLine() const { return m_preprocNoLine; }
     bool underlineZero() const { return m_underlineZero; }
     string bin() const { return m_bin; }
+    string branchFeedback() const { return m_branchFeedback; }
     string flags() const { return m_flags; }
     bool systemC() const { return m_systemC; }
     bool usingSystemCLibs() const { return !lintOnly() && systemC(); }
@@ -408,7 +418,10 @@ public:
     bool cdc() const { return m_cdc; }
     bool cmake() const { return m_cmake; }
     bool context() const { return m_context; }
-    bool coverage() const { return m_coverageLine || m_coverageToggle || m_coverageUser; }
+    bool coverage() const {
+        return m_coverageLine || m_coverageToggle || m_coverageUser || m_profBranches
+               || m_profVars;
+    }
     bool coverageLine() const { return m_coverageLine; }
     bool coverageToggle() const { return m_coverageToggle; }
     bool coverageUnderscore() const { return m_coverageUnderscore; }
@@ -429,8 +442,11 @@ public:
     bool threadsDpiUnpure() const { return m_threadsDpiUnpure; }
     bool threadsCoarsen() const { return m_threadsCoarsen; }
     bool trace() const { return m_trace; }
+    bool traceArrayWrites() const { return m_traceArrayWrites; }
     bool traceCoverage() const { return m_traceCoverage; }
     bool traceDups() const { return m_traceDups; }
+    bool traceFineActivity() const { return m_traceFineActivity; }
+    bool traceGz() const { return m_traceGz; }
     bool traceParams() const { return m_traceParams; }
     bool traceStructs() const { return m_traceStructs; }
     bool traceUnderscore() const { return m_traceUnderscore; }
@@ -442,8 +458,10 @@ public:
     bool pinsScBigUint() const { return m_pinsScBigUint; }
     bool pinsUint8() const { return m_pinsUint8; }
     bool ppComments() const { return m_ppComments; }
+    bool profBranches() const { return m_profBranches; }
     bool profCFuncs() const { return m_profCFuncs; }
     bool profThreads() const { return m_profThreads; }
+    bool profVars() const { return m_profVars; }
     bool protectIds() const { return m_protectIds; }
     bool allPublic() const { return m_public; }
     bool publicFlatRW() const { return m_publicFlatRW; }
@@ -512,6 +530,7 @@ public:
     }
     string topModule() const { return m_topModule; }
     string unusedRegexp() const { return m_unusedRegexp; }
+    string varFeedback() const { return m_varFeedback; }
     string xAssign() const { return m_xAssign; }
     string xInitial() const { return m_xInitial; }
     string xmlOutput() const { return m_xmlOutput; }
@@ -44,6 +44,7 @@ static const double TABLE_MAX_BYTES = 1 * 1024 * 1024;
 static const double TABLE_TOTAL_BYTES = 64 * 1024 * 1024;
 static const double TABLE_SPACE_TIME_MULT = 8;  // Worth 8 bytes of data to replace a instruction
 static const int TABLE_MIN_NODE_COUNT = 32;  // If < 32 instructions, not worth the effort
+static const int TABLE_MAX_PACK_WIDTH = 64;  // Largest entry when packing outputs together
 
 //######################################################################
 
@@ -73,6 +74,7 @@ private:
     // STATE
     double m_totalBytes;  // Total bytes in tables created
     VDouble0 m_statTablesCre;  // Statistic tracking
+    VDouble0 m_statTablesPacked;  // Statistic tracking
 
     //  State cleared on each module
     AstNodeModule* m_modp;  // Current MODULE
@@ -87,6 +89,7 @@ private:
     bool m_assignDly;  // Consists of delayed assignments instead of normal assignments
     int m_inWidth;  // Input table width
     int m_outWidth;  // Output table width
+    int m_packWidth;  // Bits in packed output table entry, 0 = table per output
     std::deque<AstVarScope*> m_inVarps;  // Input variable list
     std::deque<AstVarScope*> m_outVarps;  // Output variable list
     std::deque<bool> m_outNotSet;  // True if output variable is not set at some point
@@ -97,6 +100,24 @@ private:
     // METHODS
     VL_DEBUG_FUNC;  // Declare debug()
 
+    int packWidth() const {
+        // If every output is a narrow packed value, and there are several,
+        // return the total width so they can share one table entry
+        if (m_outVarps.size() < 2) return 0;
+        int width = 0;
+        for (std::deque<AstVarScope*>::const_iterator it = m_outVarps.begin();
+             it != m_outVarps.end(); ++it) {
+            const AstVar* varp = (*it)->varp();
+            const AstBasicDType* basicp = VN_CAST(varp->dtypeSkipRefp(), BasicDType);
+            if (!basicp || basicp->isOpaque() || varp->isWide()) return 0;
+            width += varp->width();
+        }
+        return (width <= TABLE_MAX_PACK_WIDTH) ? width : 0;
+    }
+    static int packBytes(int width) {
+        return (width <= 8) ? 1 : (width <= 16) ? 2 : (width <= 32) ? 4 : 8;
+    }
+
     bool treeTest(AstAlways* nodep) {
         // Process alw/assign tree
         m_inWidth = 0;
@@ -117,8 +138,10 @@ private:
         // Calc data storage in bytes
         size_t chgWidth = m_outVarps.size();  // Width of one change-it-vector
         if (chgWidth < 8) chgWidth = 8;
+        m_packWidth = packWidth();
+        int outBytes = m_packWidth ? packBytes(m_packWidth) : m_outWidth;
         double space = (pow(static_cast<double>(2.0), static_cast<double>(m_inWidth))
-                        * static_cast<double>(m_outWidth + chgWidth));
+                        * static_cast<double>(outBytes + chgWidth));
         // Instruction count bytes (ok, it's space also not time :)
         double bytesPerInst = 4;
         double time = ((chkvis.instrCount() * bytesPerInst + chkvis.dataCount())
@@ -139,7 +162,8 @@ private:
         UINFO(4, "  Test: Opt=" << (chkvis.optimizable() ? "OK" : "NO")
                                 << ", Instrs=" << chkvis.instrCount()
                                 << " Data=" << chkvis.dataCount() << " inw=" << m_inWidth
-                                << " outw=" << m_outWidth << " Spacetime=" << (space / time) << "("
+                                << " outw=" << m_outWidth << " packw=" << m_packWidth
+                                << " Spacetime=" << (space / time) << "("
                                 << space << "/" << time << ")"
                                 << ": " << nodep << endl);
         if (chkvis.optimizable()) {
@@ -170,6 +194,7 @@ private:
         // We've determined this table of nodes is optimizable, do it.
         ++m_modTables;
         ++m_statTablesCre;
+        if (m_packWidth) ++m_statTablesPacked;
 
         // Index into our table
         AstVar* indexVarp
@@ -221,6 +246,24 @@ private:
     }
 
     void createTableVars(AstNode* nodep) {
+        if (m_packWidth) {
+            // One table; each entry holds all outputs, first output in the LSBs
+            FileLine* fl = nodep->fileline();
+            AstNodeArrayDType* dtypep = new AstUnpackArrayDType(
+                fl, nodep->findBitDType(m_packWidth, m_packWidth, AstNumeric::UNSIGNED),
+                new AstRange(fl, VL_MASK_I(m_inWidth), 0));
+            v3Global.rootp()->typeTablep()->addTypesp(dtypep);
+            AstVar* tablevarp = new AstVar(fl, AstVarType::MODULETEMP,
+                                           "__Vtablepack" + cvtToStr(m_modTables), dtypep);
+            tablevarp->isConst(true);
+            tablevarp->isStatic(true);
+            tablevarp->valuep(new AstInitArray(nodep->fileline(), dtypep, NULL));
+            m_modp->addStmtp(tablevarp);
+            AstVarScope* tablevscp = new AstVarScope(tablevarp->fileline(), m_scopep, tablevarp);
+            m_scopep->addVarp(tablevscp);
+            m_tableVarps.push_back(tablevscp);
+            return;
+        }
         // Create table for each output
         typedef std::map<string, int> NameCounts;
         NameCounts namecounts;
@@ -315,7 +358,9 @@ private:
 
             // If a output changed, add it to table
             int outnum = 0;
+            int packLsb = 0;
             V3Number outputChgMask(nodep, m_outVarps.size(), 0);
+            V3Number packed(nodep, m_packWidth ? m_packWidth : 1, 0);
             for (std::deque<AstVarScope*>::iterator it = m_outVarps.begin();
                  it != m_outVarps.end(); ++it) {
                 AstVarScope* outvscp = *it;
@@ -334,10 +379,20 @@ private:
                     outputChgMask.setBit(outnum, 1);
                     setp = new AstConst(outnump->fileline(), *outnump);
                 }
-                // Note InitArray requires us to have the values in inValue order
-                VN_CAST(m_tableVarps[outnum]->varp()->valuep(), InitArray)->addValuep(setp);
+                if (m_packWidth) {
+                    packed.opSelInto(VN_CAST(setp, Const)->num(), packLsb, outvscp->width());
+                    packLsb += outvscp->width();
+                    VL_DO_DANGLING(setp->deleteTree(), setp);
+                } else {
+                    // Note InitArray requires us to have the values in inValue order
+                    VN_CAST(m_tableVarps[outnum]->varp()->valuep(), InitArray)->addValuep(setp);
+                }
                 outnum++;
             }
+            if (m_packWidth) {
+                AstNode* setp = new AstConst(nodep->fileline(), packed);
+                VN_CAST(m_tableVarps[0]->varp()->valuep(), InitArray)->addValuep(setp);
+            }
 
             {  // Set changed table
                 UASSERT_OBJ(inValue == inValueNextInitArray, nodep,
@@ -381,13 +436,19 @@ private:
         // elimination will remove it for us.
         // Set each output from array ref into our table
         int outnum = 0;
+        int packLsb = 0;
         for (std::deque<AstVarScope*>::iterator it = m_outVarps.begin(); it != m_outVarps.end();
              ++it) {
             AstVarScope* outvscp = *it;
             AstNode* alhsp = new AstVarRef(nodep->fileline(), outvscp, true);
             AstNode* arhsp = new AstArraySel(
-                nodep->fileline(), new AstVarRef(nodep->fileline(), m_tableVarps[outnum], false),
+                nodep->fileline(),
+                new AstVarRef(nodep->fileline(), m_tableVarps[m_packWidth ? 0 : outnum], false),
                 new AstVarRef(nodep->fileline(), indexVscp, false));
+            if (m_packWidth) {
+                arhsp = new AstSel(nodep->fileline(), arhsp, packLsb, outvscp->width());
+                packLsb += outvscp->width();
+            }
             AstNode* outasnp
                 = (m_assignDly
                        ? static_cast<AstNode*>(new AstAssignDly(nodep->fileline(), alhsp, arhsp))
@@ -459,11 +520,13 @@ public:
         m_assignDly = 0;
         m_inWidth = 0;
         m_outWidth = 0;
+        m_packWidth = 0;
         m_totalBytes = 0;
         iterate(nodep);
     }
     virtual ~TableVisitor() {  //
         V3Stats::addStat("Optimizations, Tables created", m_statTablesCre);
+        V3Stats::addStat("Optimizations, Tables packed", m_statTablesPacked);
     }
 };
 
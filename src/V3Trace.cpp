@@ -39,6 +39,20 @@
 //      Assign trace codes:
 //              If from a VARSCOPE, record the trace->varscope map
 //              Else, assign trace codes to each variable
+//  With --trace-fine-activity:
+//      Each statement directly in a fast CFUNC that sets traced vars gets
+//      its own activity code, set before the statement, instead of sharing
+//      the activity code(s) of the CFUNC
+//  With --trace-array-writes:
+//      For each traced simple 1-D unpacked array, make flag arrays for
+//      written elements and for written blocks of elements
+//      Before each statement writing the array, add
+//          ASSIGN(ARRAYSEL(flags,index),1), ASSIGN(ARRAYSEL(blocks,index>>shift),1)
+//      or if the index isn't known, set the last block flag meaning all elements
+//      The change function only checks the flagged elements, then clears the flags
+//  With --threads and VCD tracing:
+//      Split the change function's calls into contiguous chunks, run in
+//      parallel by VerilatedVcd::chgParallel
 //
 //*************************************************************************
 
@@ -55,15 +69,24 @@
 #include <cstdarg>
 #include <map>
 #include <set>
+#include <vector>
+
+// Minimum statements for each parallel trace change chunk
+#define TRACE_CHUNK_MIN_STMTS 1000
+// Default statements in a change sub function when making parallel chunks
+#define TRACE_CHUNK_SUB_STMTS (TRACE_CHUNK_MIN_STMTS / 4)
+// Log2 of array elements per --trace-array-writes block flag; must match V3EmitC
+#define TRACE_WRITES_BLOCK_SHIFT 6
 
 //######################################################################
 // Graph vertexes
 
 class TraceActivityVertex : public V3GraphVertex {
-    AstNode* m_insertp;  // Insert before this statement
+    AstNode* m_insertp;  // Insert after this statement
     vlsint32_t m_activityCode;
     bool m_activityCodeValid;
     bool m_slow;  // If always slow, we can use the same code
+    bool m_insertBefore;  // Insert before m_insertp, rather than after
 public:
     enum { ACTIVITY_NEVER = ((1UL << 31) - 1) };
     enum { ACTIVITY_ALWAYS = ((1UL << 31) - 2) };
@@ -74,6 +97,7 @@ public:
         m_activityCode = 0;
         m_activityCodeValid = false;
         m_slow = slow;
+        m_insertBefore = false;
     }
     TraceActivityVertex(V3Graph* graphp, vlsint32_t code)
         : V3GraphVertex(graphp)
@@ -81,6 +105,7 @@ public:
         m_activityCode = code;
         m_activityCodeValid = true;
         m_slow = false;
+        m_insertBefore = false;
     }
     virtual ~TraceActivityVertex() {}
     // ACCESSORS
@@ -107,6 +132,8 @@ public:
     void slow(bool flag) {
         if (!flag) m_slow = false;
     }
+    bool insertBefore() const { return m_insertBefore; }
+    void insertBefore(bool flag) { m_insertBefore = flag; }
 };
 
 class TraceCFuncVertex : public V3GraphVertex {
@@ -167,6 +194,16 @@ public:
 
 class TraceVisitor : public EmitCBaseVisitor {
 private:
+    // TYPES
+    struct TraceWrites {  // --trace-array-writes flags of a traced array
+        AstVarScope* m_elementsVscp;  // Flag for each written element
+        AstVarScope* m_blocksVscp;  // Flag for each written block, last is all elements
+        TraceWrites()
+            : m_elementsVscp(NULL)
+            , m_blocksVscp(NULL) {}
+    };
+    typedef std::map<AstVarScope*, TraceWrites> TraceWritesMap;
+
     // NODE STATE
     // V3Hashed
     //  Ast*::user4()                   // V3Hashed calculation
@@ -185,6 +222,8 @@ private:
     AstNodeModule* m_topModp;  // Module to add variables to
     AstScope* m_highScopep;  // Scope to add variables to
     AstCFunc* m_funcp;  // C function adding to graph
+    AstNode* m_fineStmtp;  // Statement of m_funcp with its own activity, or NULL
+    TraceActivityVertex* m_fineVtxp;  // Activity vertex for m_fineStmtp, or NULL
     AstTraceInc* m_tracep;  // Trace function adding to graph
     AstCFunc* m_initFuncp;  // Trace function we add statements to
     AstCFunc* m_fullFuncp;  // Trace function we add statements to
@@ -201,10 +240,15 @@ private:
     TraceActivityVertex* m_alwaysVtxp;  // "Always trace" vertex
     bool m_finding;  // Pass one of algorithm?
     int m_funcNum;  // Function number being built
+    TraceWritesMap m_writes;  // Arrays with --trace-array-writes tracking
+    std::vector<AstVarRef*> m_writeRefps;  // Lvalue references to m_writes arrays
 
     VDouble0 m_statChgSigs;  // Statistic tracking
     VDouble0 m_statUniqSigs;  // Statistic tracking
     VDouble0 m_statUniqCodes;  // Statistic tracking
+    VDouble0 m_statChunks;  // Statistic tracking
+    VDouble0 m_statWriteArrays;  // Statistic tracking
+    VDouble0 m_statWriteFlags;  // Statistic tracking
 
     // METHODS
     VL_DEBUG_FUNC;  // Declare debug()
@@ -312,6 +356,93 @@ private:
         }
     }
 
+    static bool writesTrackable(AstTraceInc* nodep) {
+        // Simple 1-D array (V3TraceDecl gave it a range) of a whole variable
+        if (!nodep->declp()->arrayRange().ranged()) return false;
+        AstVarRef* varrefp = VN_CAST(nodep->valuep(), VarRef);
+        return varrefp && V3Trace::writesTrackable(varrefp->varp());
+    }
+    static bool writesIndexOk(AstNode* nodep) {
+        // Index can be evaluated a second time for the write flag
+        for (; nodep; nodep = nodep->nextp()) {
+            if (!nodep->isPure() || VN_IS(nodep, NodeCCall) || nodep->isWide()) return false;
+            if (!writesIndexOk(nodep->op1p()) || !writesIndexOk(nodep->op2p())
+                || !writesIndexOk(nodep->op3p()) || !writesIndexOk(nodep->op4p())) {
+                return false;
+            }
+        }
+        return true;
+    }
+    AstVarScope* newWritesVar(FileLine* fl, const string& name, int elements) {
+        // Bytes, not bits, so may set them without locking, as with __Vm_traceActivity
+        AstNodeDType* scalarDtp = new AstBasicDType(fl, VFlagLogicPacked(), 1);
+        v3Global.rootp()->typeTablep()->addTypesp(scalarDtp);
+        AstNodeDType* arrDtp = new AstUnpackArrayDType(
+            fl, scalarDtp, new AstRange(fl, VNumRange(elements - 1, 0, false)));
+        v3Global.rootp()->typeTablep()->addTypesp(arrDtp);
+        AstVar* newvarp = new AstVar(fl, AstVarType::MODULETEMP, name, arrDtp);
+        m_topModp->addStmtp(newvarp);
+        AstVarScope* newvscp = new AstVarScope(fl, m_highScopep, newvarp);
+        m_highScopep->addVarp(newvscp);
+        return newvscp;
+    }
+    AstNode* setWritesFlag(FileLine* fl, AstVarScope* vscp, AstNode* indexp) {
+        return new AstAssign(fl, new AstArraySel(fl, new AstVarRef(fl, vscp, true), indexp),
+                             new AstConst(fl, AstConst::LogicTrue()));
+    }
+    void addWritesFlags() {
+        // Make the flag arrays
+        int num = 0;
+        for (TraceWritesMap::iterator it = m_writes.begin(); it != m_writes.end(); ++it) {
+            AstVarScope* vscp = it->first;
+            FileLine* fl = vscp->fileline();
+            const AstUnpackArrayDType* adtypep
+                = VN_CAST(vscp->dtypep()->skipRefp(), UnpackArrayDType);
+            UASSERT_OBJ(adtypep, vscp, "Traced array writes of non-array");
+            int elements = adtypep->elementsConst();
+            int blocks = ((elements + (1 << TRACE_WRITES_BLOCK_SHIFT) - 1)
+                          >> TRACE_WRITES_BLOCK_SHIFT);
+            ++num;
+            it->second.m_elementsVscp
+                = newWritesVar(fl, "__Vm_traceWrites" + cvtToStr(num), elements);
+            it->second.m_blocksVscp
+                = newWritesVar(fl, "__Vm_traceWriteBlocks" + cvtToStr(num), blocks + 1);
+            ++m_statWriteArrays;
+        }
+        // Flag before each write
+        for (std::vector<AstVarRef*>::iterator it = m_writeRefps.begin();
+             it != m_writeRefps.end(); ++it) {
+            AstVarRef* nodep = *it;
+            const TraceWrites& writes = m_writes[nodep->varScopep()];
+            FileLine* fl = nodep->fileline();
+            AstNode* stmtp = nodep;
+            while (stmtp
+                   && !(VN_IS(stmtp, NodeStmt) && VN_CAST(stmtp, NodeStmt)->isStatement())) {
+                stmtp = stmtp->backp();
+            }
+            UASSERT_OBJ(stmtp, nodep, "Array write not under statement");
+            AstArraySel* selp = VN_CAST(nodep->backp(), ArraySel);
+            if (selp && selp->fromp() == nodep && writesIndexOk(selp->bitp())) {
+                AstNode* indexp = selp->bitp();
+                stmtp->addHereThisAsNext(
+                    setWritesFlag(fl, writes.m_elementsVscp, indexp->cloneTree(false)));
+                stmtp->addHereThisAsNext(setWritesFlag(
+                    fl, writes.m_blocksVscp,
+                    new AstShiftR(fl, indexp->cloneTree(false),
+                                  new AstConst(fl, TRACE_WRITES_BLOCK_SHIFT), indexp->width())));
+            } else {
+                // e.g. $readmem or whole array assignment; flag all elements
+                const AstUnpackArrayDType* adtypep
+                    = VN_CAST(writes.m_blocksVscp->dtypep()->skipRefp(), UnpackArrayDType);
+                stmtp->addHereThisAsNext(
+                    setWritesFlag(fl, writes.m_blocksVscp,
+                                  new AstConst(fl, adtypep->elementsConst() - 1)));
+            }
+            ++m_statWriteFlags;
+        }
+        m_writeRefps.clear();
+    }
+
     void assignActivity() {
         // Select activity numbers and put into each CFunc vertex
         m_activityNumber = 1;  // Note 0 indicates "slow"
@@ -364,9 +495,14 @@ private:
                 if (!vvertexp->activityAlways()) {
                     FileLine* fl = vvertexp->insertp()->fileline();
                     uint32_t acode = vvertexp->activityCode();
-                    vvertexp->insertp()->addNextHere(
-                        new AstAssign(fl, selectActivity(fl, acode, true),
-                                      new AstConst(fl, AstConst::LogicTrue())));
+                    AstNode* setp = new AstAssign(fl, selectActivity(fl, acode, true),
+                                                  new AstConst(fl, AstConst::LogicTrue()));
+                    if (vvertexp->insertBefore()) {
+                        // Set before, as the statement may return
+                        vvertexp->insertp()->addHereThisAsNext(setp);
+                    } else {
+                        vvertexp->insertp()->addNextHere(setp);
+                    }
                 }
             }
         }
@@ -412,10 +548,18 @@ private:
         }
         return funcp;
     }
+    static bool parallelChg() {
+        return v3Global.opt.mtasks() && v3Global.opt.threads() > 1
+               && !v3Global.opt.traceFormat().fstFlavor();
+    }
     void addToChgSub(AstNode* underp, AstNode* stmtsp) {
+        int splitStmts = v3Global.opt.outputSplitCTrace();
+        if (parallelChg() && !splitStmts) {
+            // Small enough subs that chunks can be balanced, unless the user chose a size
+            splitStmts = TRACE_CHUNK_SUB_STMTS;
+        }
         if (!m_chgSubFuncp || (m_chgSubParentp != underp)
-            || (m_chgSubStmts && v3Global.opt.outputSplitCTrace()
-                && m_chgSubStmts > v3Global.opt.outputSplitCTrace())) {
+            || (m_chgSubStmts && splitStmts && m_chgSubStmts > splitStmts)) {
             m_chgSubFuncp = newCFuncSub(m_chgFuncp, underp);
             m_chgSubParentp = underp;
             m_chgSubStmts = 0;
@@ -537,6 +681,86 @@ private:
         }
     }
 
+    void splitChgChunks() {
+        // Divide the change function's sub calls into contiguous chunks,
+        // each its own function, so they can be run on the thread pool.
+        // Code order is kept, so the output matches serial tracing.
+        typedef std::vector<std::pair<AstIf*, AstCCall*> > CallVec;
+        CallVec calls;
+        int totalStmts = 0;
+        for (AstNode* stmtp = m_chgFuncp->stmtsp(); stmtp; stmtp = stmtp->nextp()) {
+            if (AstCCall* callp = VN_CAST(stmtp, CCall)) {
+                calls.push_back(make_pair(static_cast<AstIf*>(NULL), callp));
+            } else if (AstIf* ifp = VN_CAST(stmtp, If)) {
+                for (AstNode* subp = ifp->ifsp(); subp; subp = subp->nextp()) {
+                    AstCCall* callp = VN_CAST(subp, CCall);
+                    UASSERT_OBJ(callp, subp, "Expected only calls under trace activity check");
+                    calls.push_back(make_pair(ifp, callp));
+                }
+            } else {
+                stmtp->v3fatalSrc("Unexpected statement in trace change function");
+            }
+        }
+        for (CallVec::iterator it = calls.begin(); it != calls.end(); ++it) {
+            totalStmts += EmitCBaseCounterVisitor(it->second->funcp()->stmtsp()).count();
+        }
+        int chunks = std::min(v3Global.opt.threads(), totalStmts / TRACE_CHUNK_MIN_STMTS);
+        chunks = std::min(chunks, static_cast<int>(calls.size()));
+        if (chunks < 2) return;
+        UINFO(5, "  Trace change chunks " << chunks << " for " << totalStmts << " stmts" << endl);
+
+        FileLine* fl = m_chgFuncp->fileline();
+        std::vector<AstCFunc*> chunkFuncps;
+        AstCFunc* chunkp = NULL;
+        AstIf* fromIfp = NULL;  // Activity check last call was under
+        AstIf* toIfp = NULL;  // Copy of fromIfp in the chunk
+        int doneStmts = 0;
+        for (CallVec::iterator it = calls.begin(); it != calls.end(); ++it) {
+            int chunkNum = static_cast<int>(chunkFuncps.size());
+            if (!chunkp || (chunkNum < chunks && doneStmts >= totalStmts / chunks * chunkNum)) {
+                chunkp = newCFunc(AstCFuncType::TRACE_CHANGE_CHUNK,
+                                  m_chgFuncp->name() + "__Vchunk" + cvtToStr(chunkNum + 1),
+                                  m_chgFuncp);
+                // Called back from VerilatedVcd::chgParallel
+                chunkp->argTypes(v3Global.opt.traceClassBase()
+                                 + "* vcdp, void* userthis, uint32_t code");
+                chunkp->symProlog(false);
+                chunkp->isStatic(true);
+                chunkFuncps.push_back(chunkp);
+                fromIfp = NULL;
+                toIfp = NULL;
+            }
+            AstIf* ifp = it->first;
+            AstCCall* callp = it->second;
+            doneStmts += EmitCBaseCounterVisitor(callp->funcp()->stmtsp()).count();
+            callp->unlinkFrBack();
+            if (!ifp) {
+                chunkp->addStmtsp(callp);
+                fromIfp = NULL;
+            } else {
+                if (ifp != fromIfp) {
+                    toIfp = new AstIf(ifp->fileline(), ifp->condp()->cloneTree(false), NULL,
+                                      NULL);
+                    toIfp->branchPred(ifp->branchPred());
+                    chunkp->addStmtsp(toIfp);
+                    fromIfp = ifp;
+                }
+                toIfp->addIfsp(callp);
+            }
+        }
+        // Remove the now empty activity checks, and call the chunks instead
+        while (AstNode* stmtp = m_chgFuncp->stmtsp()) {
+            VL_DO_DANGLING(pushDeletep(stmtp->unlinkFrBack()), stmtp);
+        }
+        for (std::vector<AstCFunc*>::iterator it = chunkFuncps.begin(); it != chunkFuncps.end();
+             ++it) {
+            AstCCall* callp = new AstCCall(fl, *it);
+            callp->argTypes("vcdp, vlTOPp, code");
+            m_chgFuncp->addStmtsp(callp);
+        }
+        m_statChunks += chunkFuncps.size();
+    }
+
     uint32_t assignDeclCode(AstTraceDecl* nodep) {
         if (!nodep->code()) {
             nodep->code(m_code);
@@ -576,6 +800,15 @@ private:
 
         AstNode* incAddp = NULL;
         if (!codePreassigned) {
+            TraceWritesMap::iterator wit = m_writes.end();
+            if (writesTrackable(nodep)) {
+                wit = m_writes.find(VN_CAST(nodep->valuep(), VarRef)->varScopep());
+            }
+            if (wit != m_writes.end()) {
+                FileLine* fl = nodep->fileline();
+                nodep->writesp(new AstVarRef(fl, wit->second.m_elementsVscp, true),
+                               new AstVarRef(fl, wit->second.m_blocksVscp, true));
+            }
             // Add to trace cfuncs
             if (needChg) {
                 ++m_statChgSigs;
@@ -635,6 +868,9 @@ private:
         iterateChildren(nodep);
         m_finding = false;
 
+        // Flag writes to arrays, now we know where they are
+        addWritesFlags();
+
         // Detect and remove duplicate values
         detectDuplicates();
 
@@ -646,6 +882,7 @@ private:
         // Create new TRACEINCs
         assignActivity();
         putTracesIntoTree();
+        if (parallelChg()) splitChgChunks();
     }
     virtual void visit(AstNodeModule* nodep) VL_OVERRIDE {
         if (nodep->isTop()) m_topModp = nodep;
@@ -697,7 +934,21 @@ private:
             }
         }
         m_funcp = nodep;
-        iterateChildren(nodep);
+        if (m_finding && v3Global.opt.traceFineActivity() && !nodep->slow()
+            && !nodep->funcType().isTrace()) {
+            iterateAndNextNull(nodep->argsp());
+            iterateAndNextNull(nodep->initsp());
+            for (AstNode* stmtp = nodep->stmtsp(); stmtp; stmtp = stmtp->nextp()) {
+                // Calls get activity codes from visit(AstCCall)
+                if (!VN_IS(stmtp, CCall)) m_fineStmtp = stmtp;
+                iterate(stmtp);
+                m_fineStmtp = NULL;
+                m_fineVtxp = NULL;
+            }
+            iterateAndNextNull(nodep->finalsp());
+        } else {
+            iterateChildren(nodep);
+        }
         m_funcp = NULL;
     }
     virtual void visit(AstTraceInc* nodep) VL_OVERRIDE {
@@ -709,6 +960,9 @@ private:
         nodep->user1p(vertexp);
 
         UASSERT_OBJ(m_funcp && m_chgFuncp && m_fullFuncp, nodep, "Trace not under func");
+        if (writesTrackable(nodep)) {
+            m_writes[VN_CAST(nodep->valuep(), VarRef)->varScopep()];  // Create entry
+        }
         m_tracep = nodep;
         iterateChildren(nodep);
         m_tracep = NULL;
@@ -730,9 +984,18 @@ private:
             }
         } else if (m_funcp && m_finding && nodep->lvalue()) {
             UASSERT_OBJ(nodep->varScopep(), nodep, "No var scope?");
-            V3GraphVertex* funcVtxp = getCFuncVertexp(m_funcp);
+            if (m_writes.find(nodep->varScopep()) != m_writes.end()) {
+                m_writeRefps.push_back(nodep);
+            }
             V3GraphVertex* varVtxp = nodep->varScopep()->user1u().toGraphVertex();
-            if (varVtxp) {  // else we're not tracing this signal
+            if (varVtxp && m_fineStmtp) {  // Statement has its own activity code
+                if (!m_fineVtxp) {
+                    m_fineVtxp = new TraceActivityVertex(&m_graph, m_fineStmtp, false);
+                    m_fineVtxp->insertBefore(true);
+                }
+                new V3GraphEdge(&m_graph, m_fineVtxp, varVtxp, 1);
+            } else if (varVtxp) {  // else we're not tracing this signal
+                V3GraphVertex* funcVtxp = getCFuncVertexp(m_funcp);
                 new V3GraphEdge(&m_graph, funcVtxp, varVtxp, 1);
             }
         }
@@ -744,6 +1007,8 @@ public:
     // CONSTRUCTORS
     explicit TraceVisitor(AstNetlist* nodep) {
         m_funcp = NULL;
+        m_fineStmtp = NULL;
+        m_fineVtxp = NULL;
         m_tracep = NULL;
         m_topModp = NULL;
         m_highScopep = NULL;
@@ -767,12 +1032,22 @@ public:
         V3Stats::addStat("Tracing, Unique changing signals", m_statChgSigs);
         V3Stats::addStat("Tracing, Unique traced signals", m_statUniqSigs);
         V3Stats::addStat("Tracing, Unique trace codes", m_statUniqCodes);
+        V3Stats::addStat("Tracing, Activity codes", m_activityNumber);
+        V3Stats::addStat("Tracing, Parallel change chunks", m_statChunks);
+        V3Stats::addStat("Tracing, Write tracked arrays", m_statWriteArrays);
+        V3Stats::addStat("Tracing, Write tracked array writes", m_statWriteFlags);
     }
 };
 
 //######################################################################
 // Trace class functions
 
+bool V3Trace::writesTrackable(const AstVar* varp) {
+    // Writes must all be visible to us, so not from outside the model
+    return (v3Global.opt.traceArrayWrites() && !varp->isPrimaryInish()
+            && !varp->isSigPublic());
+}
+
 void V3Trace::traceAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
     { TraceVisitor visitor(nodep); }  // Destruct before checking
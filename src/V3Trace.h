@@ -28,6 +28,9 @@
 class V3Trace {
 public:
     static void traceAll(AstNetlist* nodep);
+    // True if --trace-array-writes may track the writes to this simple 1-D array,
+    // so V3TraceDecl need not apply --trace-max-array to it
+    static bool writesTrackable(const AstVar* varp);
 };
 
 #endif  // Guard
@@ -25,6 +25,7 @@
 
 #include "V3Global.h"
 #include "V3TraceDecl.h"
+#include "V3Trace.h"
 #include "V3EmitCBase.h"
 #include "V3Stats.h"
 
@@ -242,12 +243,17 @@ private:
     virtual void visit(AstUnpackArrayDType* nodep) VL_OVERRIDE {
         // Note more specific dtypes above
         if (m_traVscp) {
-            if (static_cast<int>(nodep->arrayUnpackedElements()) > v3Global.opt.traceMaxArray()) {
+            bool simple = (VN_IS(nodep->subDTypep()->skipRefToEnump(),
+                                 BasicDType)  // Nothing lower than this array
+                           && m_traVscp->dtypep()->skipRefToEnump()
+                                  == nodep);  // Nothing above this array
+            // With --trace-array-writes V3Trace only checks the written elements,
+            // so large memories may be traced
+            bool writesTracked = simple && V3Trace::writesTrackable(m_traVscp->varp());
+            if (static_cast<int>(nodep->arrayUnpackedElements()) > v3Global.opt.traceMaxArray()
+                && !writesTracked) {
                 addIgnore("Wide memory > --trace-max-array ents");
-            } else if (VN_IS(nodep->subDTypep()->skipRefToEnump(),
-                             BasicDType)  // Nothing lower than this array
-                       && m_traVscp->dtypep()->skipRefToEnump()
-                              == nodep) {  // Nothing above this array
+            } else if (simple) {
                 // Simple 1-D array, use existing V3EmitC runtime loop rather than unrolling
                 // This will put "(index)" at end of signal name for us
                 if (m_traVscp->dtypep()->skipRefToEnump()->isString()) {
@@ -145,6 +145,8 @@ static void process() {
     // Coverage insertion
     //    Before we do dead code elimination and inlining, or we'll lose it.
     if (v3Global.opt.coverage()) V3Coverage::coverage(v3Global.rootp());
+    // Before V3Const/V3Dead, so the source positions match the --prof-vars build
+    if (!v3Global.opt.varFeedback().empty()) V3Coverage::varFeedback(v3Global.rootp());
 
     // Push constants, but only true constants preserving liveness
     // so V3Undriven sees variables to be eliminated, ie "if (0 && foo) ..."
@@ -20,6 +20,8 @@
 #include "config_build.h"
 #include "verilatedos.h"
 
+#include <algorithm>
+
 //********************************************************************
 // VlcBuckets - Container of all coverage point hits for a given test
 // This is a bitmap array - we store a single bit to indicate a test
@@ -34,6 +36,12 @@ private:
 
 private:
     static inline vluint64_t covBit(vluint64_t point) { return 1ULL << (point & 63); }
+    static inline vluint64_t countOnes(vluint64_t word) {
+        word = word - ((word >> 1) & 0x5555555555555555ULL);
+        word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+        word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return (word * 0x0101010101010101ULL) >> 56;
+    }
     inline vluint64_t allocSize() const { return sizeof(vluint64_t) * m_dataSize / 64; }
     void allocate(vluint64_t point) {
         vluint64_t oldsize = m_dataSize;
@@ -104,17 +112,18 @@ public:
         }
         return pop;
     }
-    vluint64_t dataPopCount(const VlcBuckets& remaining) {
+    vluint64_t dataPopCount(const VlcBuckets& remaining) const {
+        // A word at a time; sizes are multiples of 64
         vluint64_t pop = 0;
-        for (vluint64_t i = 0; i < m_dataSize; i++) {
-            if (hits(i) && remaining.hits(i)) pop++;
+        const vluint64_t words = std::min(m_dataSize, remaining.m_dataSize) / 64;
+        for (vluint64_t i = 0; i < words; i++) {
+            pop += countOnes(m_datap[i] & remaining.m_datap[i]);
         }
         return pop;
     }
     void orData(const VlcBuckets& ordata) {
-        for (vluint64_t i = 0; i < m_dataSize; i++) {
-            if (hits(i) && ordata.hits(i)) clearHits(i);
-        }
+        const vluint64_t words = std::min(m_dataSize, ordata.m_dataSize) / 64;
+        for (vluint64_t i = 0; i < words; i++) m_datap[i] &= ~ordata.m_datap[i];
     }
 
     void dump() const {
@@ -99,6 +99,10 @@ void VlcOptions::parseOptsList(int argc, char** argv) {
             } else if (!strcmp(sw, "-debugi") && (i + 1) < argc) {
                 shift;
                 V3Error::debugDefault(atoi(argv[i]));
+            } else if (!strcmp(sw, "-threads") && (i + 1) < argc) {
+                shift;
+                m_threads = atoi(argv[i]);
+                if (m_threads < 1) v3fatal("--threads must be >= 1: " << argv[i]);
             } else if (!strcmp(sw, "-V")) {
                 showVersion(true);
                 exit(0);
@@ -149,13 +153,7 @@ int main(int argc, char** argv, char** /*env*/) {
 
     if (top.opt.readFiles().empty()) top.opt.addReadFile("vlt_coverage.dat");
 
-    {
-        const VlStringSet& readFiles = top.opt.readFiles();
-        for (VlStringSet::const_iterator it = readFiles.begin(); it != readFiles.end(); ++it) {
-            string filename = *it;
-            top.readCoverage(filename);
-        }
-    }
+    top.readCoverageFiles(top.opt.readFiles());
 
     if (debug() >= 9) {
         top.tests().dump(true);
@@ -41,6 +41,7 @@ class VlcOptions {
     VlStringSet m_readFiles;    // main switch: --read
     bool m_rank;                // main switch: --rank
     bool m_unlink;              // main switch: --unlink
+    int m_threads;              // main switch: --threads
     string m_writeFile;         // main switch: --write
     // clang-format on
 
@@ -55,6 +56,7 @@ public:
         m_annotateAll = false;
         m_annotateMin = 10;
         m_rank = false;
+        m_threads = 1;
         m_unlink = false;
     }
     ~VlcOptions() {}
@@ -70,6 +72,7 @@ public:
     bool annotateAll() const { return m_annotateAll; }
     int annotateMin() const { return m_annotateMin; }
     bool rank() const { return m_rank; }
+    int threads() const { return m_threads; }
     bool unlink() const { return m_unlink; }
     string writeFile() const { return m_writeFile; }
 
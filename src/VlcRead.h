@@ -0,0 +1,135 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: verilator_coverage: Coverage file reading
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2020 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#ifndef _VLCREAD_H_
+#define _VLCREAD_H_ 1
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include "V3Os.h"
+
+#include "verilated_cov_key.h"
+
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+//######################################################################
+// Coverage file parsing, shared by the serial and threaded readers and
+// by V3Branch's --branch-feedback and V3Coverage's --var-feedback
+// These do not call V3Error, so may be used from worker threads
+
+inline vluint64_t vlcBinaryGet(const string& data, size_t& pos, bool& ok) {
+    // Unsigned LEB128 integer from a binary coverage file
+    vluint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= data.length()) break;
+        unsigned char c = static_cast<unsigned char>(data[pos++]);
+        value |= static_cast<vluint64_t>(c & 0x7f) << shift;
+        if (!(c & 0x80)) return value;
+    }
+    ok = false;
+    pos = data.length();
+    return 0;
+}
+
+template <class T_Add> bool vlcParseCoverageBinary(std::istream& is, T_Add& add) {
+    // See VerilatedCov::writeBinary for the format
+    const string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    size_t pos = 0;
+    bool ok = true;
+    vluint64_t nstrings = vlcBinaryGet(data, pos, ok);
+    if (nstrings > data.length()) ok = false;  // Each needs a length
+    std::vector<string> strings(ok ? nstrings : 0);
+    for (std::vector<string>::iterator it = strings.begin(); ok && it != strings.end(); ++it) {
+        size_t len = vlcBinaryGet(data, pos, ok);
+        if (data.length() - pos < len) {
+            ok = false;
+            break;
+        }
+        it->assign(data, pos, len);
+        pos += len;
+    }
+    vluint64_t npoints = vlcBinaryGet(data, pos, ok);
+    string point;
+    for (vluint64_t p = 0; ok && p < npoints; ++p) {
+        vluint64_t hits = vlcBinaryGet(data, pos, ok);
+        vluint32_t npairs = vlcBinaryGet(data, pos, ok);
+        point.clear();
+        for (vluint32_t i = 0; ok && i < npairs; ++i) {
+            vluint32_t key = vlcBinaryGet(data, pos, ok);
+            vluint32_t value = vlcBinaryGet(data, pos, ok);
+            if (key >= strings.size() || value >= strings.size()) ok = false;
+            if (!ok) break;
+            point += '\001';
+            point += strings[key];
+            point += '\002';
+            point += strings[value];
+        }
+        if (ok) add(point, hits);
+    }
+    return ok;
+}
+
+template <class T_Add> bool vlcParseCoverage(std::istream& is, T_Add& add) {
+    // Call add(point, hits) for each point in a coverage file.
+    // Return false if the file is corrupt.
+
+    // Binary files written by VerilatedCov::writeBinary
+    const string magic = VL_COV_BINARY_MAGIC;
+    string header(magic.length(), '\0');
+    is.read(&header[0], header.length());
+    if (is.gcount() == static_cast<std::streamsize>(magic.length()) && header == magic) {
+        return vlcParseCoverageBinary(is, add);
+    }
+    is.clear();
+    is.seekg(0);
+
+    while (!is.eof()) {
+        string line = V3Os::getline(is);
+        // UINFO(9," got "<<line<<endl);
+        if (line[0] == 'C') {
+            string::size_type secspace = 3;
+            for (; secspace < line.length(); secspace++) {
+                if (line[secspace] == '\'' && line[secspace + 1] == ' ') break;
+            }
+            string point = line.substr(3, secspace - 3);
+            vluint64_t hits = atoll(line.c_str() + secspace + 1);
+            // UINFO(9,"   point '"<<point<<"'"<<" "<<hits<<endl);
+            add(point, hits);
+        }
+    }
+    return true;
+}
+
+inline string vlcKeyExtract(const string& name, const char* shortKey) {
+    // Return the value of a short key in a coverage point name, or ""
+    size_t shortLen = strlen(shortKey);
+    for (const char* cp = name.c_str(); *cp; ++cp) {
+        if (*cp == '\001') {
+            if (0 == strncmp(cp + 1, shortKey, shortLen) && cp[shortLen + 1] == '\002') {
+                cp += shortLen + 2;  // Skip \001+short+\002
+                const char* ep = cp;
+                while (*ep && *ep != '\001') ++ep;
+                return string(cp, ep - cp);
+            }
+        }
+    }
+    return "";
+}
+
+#endif  // Guard
@@ -17,18 +17,137 @@
 #include "V3Error.h"
 #include "V3Os.h"
 #include "VlcOptions.h"
+#include "VlcRead.h"
 #include "VlcTop.h"
 
 #include <algorithm>
 #include <fstream>
+#include <iterator>
+#include <map>
+#include <queue>
+#include <vector>
 #include <sys/stat.h>
+#if __cplusplus >= 201103L
+# include <thread>
+#endif
+
+//######################################################################
+// Points read by vlcParseCoverage
+
+typedef std::map<string, vluint64_t> VlcPointCounts;
+typedef std::vector<std::pair<string, vluint64_t> > VlcPointList;
+
+class VlcAddToTop {
+    // Add points directly to the top, for a serial read
+    VlcTop* m_topp;
+    VlcTest* m_testp;
+
+public:
+    VlcAddToTop(VlcTop* topp, VlcTest* testp)
+        : m_topp(topp)
+        , m_testp(testp) {}
+    void operator()(const string& point, vluint64_t hits) {
+        m_topp->readCoveragePoint(m_testp, point, hits);
+    }
+};
+
+class VlcAddToCounts {
+    // Sum points over files, for a threaded read without ranking
+    VlcPointCounts& m_counts;
+
+public:
+    explicit VlcAddToCounts(VlcPointCounts& counts)
+        : m_counts(counts) {}
+    void operator()(const string& point, vluint64_t hits) { m_counts[point] += hits; }
+};
+
+class VlcAddToList {
+    // Keep one file's points in order, for a threaded read with ranking
+    VlcPointList& m_list;
+
+public:
+    explicit VlcAddToList(VlcPointList& list)
+        : m_list(list) {}
+    void operator()(const string& point, vluint64_t hits) {
+        m_list.push_back(std::make_pair(point, hits));
+    }
+};
+
+//######################################################################
+// VlcReadJob - Files read by one thread
+
+class VlcReadJob {
+public:
+    // MEMBERS
+    std::vector<string> m_filenames;  // Files to read
+    VlcPointCounts m_counts;  // Points summed over files, if summing
+    VlcPointList m_list;  // Points of the only file, if not summing
+    string m_error;  // Error message, reported later by the main thread
+    VlcReadJob* m_mergep;  // Job to absorb on the next merge()
+
+    // CONSTRUCTORS
+    VlcReadJob()
+        : m_mergep(NULL) {}
+
+    // METHODS
+    void readFile(const string& filename, bool sum) {
+        std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!is) {
+            m_error = "Can't read " + filename;
+            return;
+        }
+        VlcAddToCounts addCounts(m_counts);
+        VlcAddToList addList(m_list);
+        if (!(sum ? vlcParseCoverage(is, addCounts) : vlcParseCoverage(is, addList))) {
+            m_error = "Corrupt binary coverage file: " + filename;
+        }
+    }
+    void readSummed() {
+        for (std::vector<string>::const_iterator it = m_filenames.begin();
+             it != m_filenames.end() && m_error.empty(); ++it) {
+            readFile(*it, true);
+        }
+    }
+    void readListed() { readFile(m_filenames.front(), false); }
+    void merge() {
+        // Absorb m_mergep's points.
+        // Both maps are sorted, so insert each point just before the next
+        VlcReadJob* rhsp = m_mergep;
+        if (!rhsp) return;
+        m_mergep = NULL;
+        VlcPointCounts::iterator hint = m_counts.begin();
+        for (VlcPointCounts::const_iterator it = rhsp->m_counts.begin();
+             it != rhsp->m_counts.end(); ++it) {
+            hint = m_counts.insert(hint, std::make_pair(it->first, 0));
+            hint->second += it->second;
+            ++hint;
+        }
+        VlcPointCounts().swap(rhsp->m_counts);
+        if (m_error.empty()) m_error = rhsp->m_error;
+    }
+};
+
+static void vlcRunJobs(std::vector<VlcReadJob>& jobs, size_t first, size_t step,
+                       void (VlcReadJob::*methodp)()) {
+    // Call methodp on jobs first, first+step, ..., one thread each
+#if __cplusplus >= 201103L
+    std::vector<std::thread> threads;
+    for (size_t i = first + step; i < jobs.size(); i += step) {
+        threads.push_back(std::thread(methodp, &jobs[i]));
+    }
+    if (first < jobs.size()) (jobs[first].*methodp)();
+    for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+#else
+    for (size_t i = first; i < jobs.size(); i += step) (jobs[i].*methodp)();
+#endif
+}
 
 //######################################################################
 
 void VlcTop::readCoverage(const string& filename, bool nonfatal) {
     UINFO(2, "readCoverage " << filename << endl);
 
-    std::ifstream is(filename.c_str());
+    std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
     if (!is) {
         if (!nonfatal) v3fatal("Can't read " << filename);
         return;
@@ -37,27 +156,77 @@ void VlcTop::readCoverage(const string& filename, bool nonfatal) {
     // Testrun and computrons argument unsupported as yet
     VlcTest* testp = tests().newTest(filename, 0, 0);
 
-    while (!is.eof()) {
-        string line = V3Os::getline(is);
-        // UINFO(9," got "<<line<<endl);
-        if (line[0] == 'C') {
-            string::size_type secspace = 3;
-            for (; secspace < line.length(); secspace++) {
-                if (line[secspace] == '\'' && line[secspace + 1] == ' ') break;
+    VlcAddToTop add(this, testp);
+    if (!vlcParseCoverage(is, add)) v3fatal("Corrupt binary coverage file: " << filename);
+}
+
+void VlcTop::readCoverageFiles(const VlStringSet& filenames) {
+    const size_t threads = std::min(static_cast<size_t>(opt.threads()), filenames.size());
+    if (threads <= 1) {
+        for (VlStringSet::const_iterator it = filenames.begin(); it != filenames.end(); ++it) {
+            readCoverage(*it);
+        }
+        return;
+    }
+    UINFO(2, "readCoverageFiles " << filenames.size() << " files with " << threads
+                                  << " threads" << endl);
+    if (opt.rank()) {
+        // Ranking needs each test's points, so read a batch of files in
+        // parallel, then add them in order; only one batch is in memory
+        VlStringSet::const_iterator it = filenames.begin();
+        while (it != filenames.end()) {
+            std::vector<VlcReadJob> jobs;
+            for (; it != filenames.end() && jobs.size() < threads; ++it) {
+                jobs.push_back(VlcReadJob());
+                jobs.back().m_filenames.push_back(*it);
             }
-            string point = line.substr(3, secspace - 3);
-            vluint64_t hits = atoll(line.c_str() + secspace + 1);
-            // UINFO(9,"   point '"<<point<<"'"<<" "<<hits<<endl);
-
-            vluint64_t pointnum = points().findAddPoint(point, hits);
-            if (pointnum) {}  // Prevent unused
-            if (opt.rank()) {  // Only if ranking - uses a lot of memory
-                if (hits >= VlcBuckets::sufficient()) {
-                    points().pointNumber(pointnum).testsCoveringInc();
-                    testp->buckets().addData(pointnum, hits);
+            vlcRunJobs(jobs, 0, 1, &VlcReadJob::readListed);
+            for (std::vector<VlcReadJob>::iterator jit = jobs.begin(); jit != jobs.end(); ++jit) {
+                if (!jit->m_error.empty()) v3fatal(jit->m_error);
+                // Testrun and computrons argument unsupported as yet
+                VlcTest* testp = tests().newTest(jit->m_filenames.front(), 0, 0);
+                for (VlcPointList::const_iterator pit = jit->m_list.begin();
+                     pit != jit->m_list.end(); ++pit) {
+                    readCoveragePoint(testp, pit->first, pit->second);
                 }
             }
         }
+        return;
+    }
+
+    // Otherwise each thread sums its share of the files, and the sums are
+    // combined pairwise in parallel.  Memory is bounded by the number of
+    // distinct points per thread, not by the number of files.
+    std::vector<VlcReadJob> jobs(threads);
+    size_t n = 0;
+    for (VlStringSet::const_iterator it = filenames.begin(); it != filenames.end(); ++it, ++n) {
+        jobs[n % threads].m_filenames.push_back(*it);
+        // Testrun and computrons argument unsupported as yet
+        tests().newTest(*it, 0, 0);
+    }
+    vlcRunJobs(jobs, 0, 1, &VlcReadJob::readSummed);
+    for (size_t step = 1; step < jobs.size(); step *= 2) {
+        // Job i absorbs job i+step, for each i a multiple of 2*step
+        for (size_t i = 0; i < jobs.size(); i += 2 * step) {
+            jobs[i].m_mergep = (i + step < jobs.size()) ? &jobs[i + step] : NULL;
+        }
+        vlcRunJobs(jobs, 0, 2 * step, &VlcReadJob::merge);
+    }
+    if (!jobs[0].m_error.empty()) v3fatal(jobs[0].m_error);
+    for (VlcPointCounts::const_iterator it = jobs[0].m_counts.begin();
+         it != jobs[0].m_counts.end(); ++it) {
+        points().findAddPoint(it->first, it->second);
+    }
+}
+
+void VlcTop::readCoveragePoint(VlcTest* testp, const string& point, vluint64_t hits) {
+    vluint64_t pointnum = points().findAddPoint(point, hits);
+    if (pointnum) {}  // Prevent unused
+    if (opt.rank()) {  // Only if ranking - uses a lot of memory
+        if (hits >= VlcBuckets::sufficient()) {
+            points().pointNumber(pointnum).testsCoveringInc();
+            testp->buckets().addData(pointnum, hits);
+        }
     }
 }
 
@@ -88,6 +257,24 @@ struct CmpComputrons {
     }
 };
 
+struct VlcRankEntry {
+    vluint64_t m_remain;  // Points the test adds, as of m_rank
+    size_t m_index;  // Index of test in computron order
+    vluint64_t m_rank;  // Rank being chosen when m_remain was counted
+    VlcRankEntry(vluint64_t remain, size_t index, vluint64_t rank)
+        : m_remain(remain)
+        , m_index(index)
+        , m_rank(rank) {}
+};
+
+struct CmpRankEntry {
+    // Most remaining points first, then fastest test first
+    inline bool operator()(const VlcRankEntry& lhs, const VlcRankEntry& rhs) const {
+        if (lhs.m_remain != rhs.m_remain) return lhs.m_remain < rhs.m_remain;
+        return lhs.m_index > rhs.m_index;
+    }
+};
+
 void VlcTop::rank() {
     UINFO(2, "rank...\n");
     vluint64_t nextrank = 1;
@@ -109,34 +296,33 @@ void VlcTop::rank() {
         if (pointp->testsCovering()) remaining.addData(pointp->pointNum(), 1);
     }
 
-    // Additional Greedy algorithm
-    // O(n^2) Ouch.  Probably the thing to do is randomize the order of data
-    // then hierarchically solve a small subset of tests, and take resulting
-    // solution and move up to larger subset of tests.  (Aka quick sort.)
-    while (true) {
+    // Greedy algorithm, evaluated lazily.  The points a test would add can
+    // only shrink as other tests are ranked, so a stale count is an upper
+    // bound; a test is recounted only when its bound reaches the top of the
+    // queue, and is chosen when its fresh count still does.  This picks the
+    // same tests in the same order as recounting every test on every pass.
+    std::priority_queue<VlcRankEntry, std::vector<VlcRankEntry>, CmpRankEntry> queue;
+    for (size_t i = 0; i < bytime.size(); ++i) {
+        queue.push(VlcRankEntry(bytime[i]->buckets().dataPopCount(remaining), i, nextrank));
+    }
+    while (!queue.empty()) {
+        VlcRankEntry entry = queue.top();
+        queue.pop();
+        if (!entry.m_remain) break;  // No test covering more stuff found
+        VlcTest* testp = bytime[entry.m_index];
+        if (entry.m_rank != nextrank) {  // Stale count, recount and requeue
+            entry.m_remain = testp->buckets().dataPopCount(remaining);
+            entry.m_rank = nextrank;
+            queue.push(entry);
+            continue;
+        }
         if (debug()) {
             UINFO(9, "Left on iter" << nextrank << ": ");
             remaining.dump();
         }
-        VlcTest* bestTestp = NULL;
-        vluint64_t bestRemain = 0;
-        for (std::vector<VlcTest*>::iterator it = bytime.begin(); it != bytime.end(); ++it) {
-            VlcTest* testp = *it;
-            if (!testp->rank()) {
-                vluint64_t remain = testp->buckets().dataPopCount(remaining);
-                if (remain > bestRemain) {
-                    bestTestp = testp;
-                    bestRemain = remain;
-                }
-            }
-        }
-        if (VlcTest* testp = bestTestp) {
-            testp->rank(nextrank++);
-            testp->rankPoints(bestRemain);
-            remaining.orData(bestTestp->buckets());
-        } else {
-            break;  // No test covering more stuff found
-        }
+        testp->rank(nextrank++);
+        testp->rankPoints(entry.m_remain);
+        remaining.orData(testp->buckets());
     }
 }
 
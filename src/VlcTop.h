@@ -57,6 +57,8 @@ public:
     // METHODS
     void annotate(const string& dirname);
     void readCoverage(const string& filename, bool nonfatal = false);
+    void readCoverageFiles(const VlStringSet& filenames);
+    void readCoveragePoint(VlcTest* testp, const string& point, vluint64_t hits);
     void writeCoverage(const string& filename);
 
     void rank();
@@ -0,0 +1,395 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: verilator_trace_conv: main()
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2020 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+// Converts a raw trace file, written by VerilatedVcd when the filename
+// ends in ".vtr", to VCD.  See VL_TRACE_RAW_MAGIC in verilated_vcd_c.h
+// for the format.
+//
+// The records are first scanned for time changes, which split the file
+// into chunks.  Each chunk only depends on its own records, so chunks
+// are formatted in parallel, then written in order.
+//*************************************************************************
+
+// clang-format off
+#include "config_build.h"
+#ifndef HAVE_CONFIG_BUILD
+# error "Something failed during ./configure as config_build.h is incomplete. Perhaps you used autoreconf, don't."
+#endif
+// clang-format on
+
+#include "verilatedos.h"
+#include "config_rev.h"
+
+// Cheat for speed and compile .cpp files into one object
+#define _V3ERROR_NO_GLOBAL_ 1
+#include "V3Error.cpp"
+#include "V3String.cpp"
+#include "V3Os.cpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/stat.h>
+#include <vector>
+#if __cplusplus >= 201103L
+# include <thread>
+#endif
+#ifndef _WIN32
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+// Must match verilated_vcd_c.h
+#define VL_TRACE_RAW_MAGIC "VLTRACE1\n"
+#define VL_TRACE_RAW_REAL 0x80000000U
+
+// Input bytes formatted by each thread at a time
+#define VTC_CHUNK_BYTES (8 * 1024 * 1024)
+
+//######################################################################
+// VtcOptions
+
+class VtcOptions {
+public:
+    // MEMBERS
+    string m_readFile;  // Raw trace file to read
+    string m_writeFile;  // VCD file to write
+    int m_threads;  // main switch: --threads
+    // CONSTRUCTORS
+    VtcOptions()
+        : m_threads(1) {}
+    // METHODS
+    void parseOptsList(int argc, char** argv);
+    static string version();
+    static void showVersion(bool verbose);
+};
+
+string VtcOptions::version() {
+    string ver = DTVERSION;
+    ver += " rev " + cvtToStr(DTVERSION_rev);
+    return ver;
+}
+
+void VtcOptions::parseOptsList(int argc, char** argv) {
+    // Parse parameters
+    // Note argc and argv DO NOT INCLUDE the filename in [0]!!!
+#define shift \
+    { ++i; }
+    for (int i = 0; i < argc;) {
+        UINFO(9, " Option: " << argv[i] << endl);
+        if (argv[i][0] == '-' && argv[i][1]) {
+            const char* sw = argv[i];
+            // Allow gnu -- switches
+            if (sw[0] == '-' && sw[1] == '-') ++sw;
+            if (!strcmp(sw, "-debug")) {
+                V3Error::debugDefault(3);
+            } else if (!strcmp(sw, "-debugi") && (i + 1) < argc) {
+                shift;
+                V3Error::debugDefault(atoi(argv[i]));
+            } else if (!strcmp(sw, "-threads") && (i + 1) < argc) {
+                shift;
+                m_threads = atoi(argv[i]);
+                if (m_threads < 1) v3fatal("--threads must be >= 1: " << argv[i]);
+            } else if (!strcmp(sw, "-V")) {
+                showVersion(true);
+                exit(0);
+            } else if (!strcmp(sw, "-version")) {
+                showVersion(false);
+                exit(0);
+            } else {
+                v3fatal("Invalid option: " << argv[i]);
+            }
+            shift;
+        }  // - options
+        else if (m_readFile.empty()) {
+            m_readFile = argv[i];
+            shift;
+        } else if (m_writeFile.empty()) {
+            m_writeFile = argv[i];
+            shift;
+        } else {
+            v3fatal("Too many filenames: " << argv[i]);
+        }
+    }
+#undef shift
+}
+
+void VtcOptions::showVersion(bool verbose) {
+    cout << version();
+    cout << endl;
+    if (!verbose) return;
+
+    cout << endl;
+    cout << "Copyright 2020 by Wilson Snyder.  Verilator is free software; you can\n";
+    cout << "redistribute it and/or modify the Verilator internals under the terms of\n";
+    cout << "either the GNU Lesser General Public License Version 3 or the Perl Artistic\n";
+    cout << "License Version 2.0.\n";
+
+    cout << endl;
+    cout << "See https://verilator.org for documentation\n";
+}
+
+//######################################################################
+// VtcInput - Raw trace file contents, mapped if possible
+
+class VtcInput {
+    const char* m_datap;  // File contents
+    size_t m_size;  // Size of file
+    bool m_mapped;  // m_datap is a mapping, else owned copy
+public:
+    // CONSTRUCTORS
+    VtcInput()
+        : m_datap(NULL)
+        , m_size(0)
+        , m_mapped(false) {}
+    ~VtcInput() {
+#ifndef _WIN32
+        if (m_mapped) munmap(const_cast<char*>(m_datap), m_size);
+#endif
+        if (!m_mapped) delete[] m_datap;
+    }
+    // ACCESSORS
+    const char* datap() const { return m_datap; }
+    size_t size() const { return m_size; }
+    // METHODS
+    void read(const string& filename) {
+#ifndef _WIN32
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) v3fatal("Can't read " << filename);
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* mapp = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapp != MAP_FAILED) {
+                m_datap = static_cast<const char*>(mapp);
+                m_size = st.st_size;
+                m_mapped = true;
+            }
+        }
+        ::close(fd);
+        if (m_mapped) return;
+#endif
+        // Fall back to reading a copy
+        std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!is) v3fatal("Can't read " << filename);
+        is.seekg(0, std::ios::end);
+        m_size = is.tellg();
+        is.seekg(0, std::ios::beg);
+        char* bufp = new char[m_size + 1];
+        is.read(bufp, m_size);
+        m_datap = bufp;
+    }
+};
+
+//######################################################################
+// VtcChunk - Records between two offsets, and their VCD text
+
+class VtcChunk {
+    size_t m_begin;  // Offset of first record
+    size_t m_end;  // Offset after last record
+    string m_text;  // Formatted VCD
+
+    static char* writeCode(char* writep, vluint32_t code) {
+        // Same as VerilatedVcd::writeCode
+        *writep++ = static_cast<char>('!' + code % 94);
+        code /= 94;
+        while (code) {
+            code--;
+            *writep++ = static_cast<char>('!' + code % 94);
+            code /= 94;
+        }
+        return writep;
+    }
+
+public:
+    VtcChunk(size_t begin, size_t end)
+        : m_begin(begin)
+        , m_end(end) {}
+    const string& text() const { return m_text; }
+    void clear() { string().swap(m_text); }
+
+    void format(const char* datap) {
+        // Same output as VerilatedVcd's fullBit/fullBus/fullArray/fullDouble
+        m_text.reserve((m_end - m_begin) * 2);
+        char buf[64];
+        vluint32_t rec[2];
+        for (size_t pos = m_begin; pos < m_end;) {
+            memcpy(rec, datap + pos, sizeof(rec));
+            if (rec[0] == 0) {  // Time change
+                vluint32_t hi;
+                memcpy(&hi, datap + pos + 8, sizeof(hi));
+                const vluint64_t timeui = (static_cast<vluint64_t>(hi) << 32) | rec[1];
+                sprintf(buf, "#%" VL_PRI64 "u\n", timeui);
+                m_text += buf;
+                pos += 12;
+                continue;
+            }
+            const vluint32_t code = rec[0];
+            const vluint32_t width = rec[1];
+            const size_t words = ((width & ~VL_TRACE_RAW_REAL) + 31) / 32;
+            const char* const valp = datap + pos + 8;
+            pos += 8 + words * 4;
+            if (width & VL_TRACE_RAW_REAL) {
+                double val;
+                if ((width & ~VL_TRACE_RAW_REAL) == 32) {
+                    float fval;
+                    memcpy(&fval, valp, sizeof(fval));
+                    val = fval;
+                } else {
+                    memcpy(&val, valp, sizeof(val));
+                }
+                sprintf(buf, "r%.16g ", val);
+                m_text += buf;
+            } else if (width == 1) {
+                m_text += static_cast<char>('0' | (valp[0] & 1));
+            } else {
+                m_text += 'b';
+                vluint32_t word = 0;
+                for (int bit = width - 1; bit >= 0; --bit) {
+                    if (bit == static_cast<int>(width - 1) || (bit & 31) == 31) {
+                        memcpy(&word, valp + (bit / 32) * 4, sizeof(word));
+                    }
+                    m_text += static_cast<char>('0' | ((word >> (bit & 31)) & 1));
+                }
+                m_text += ' ';
+            }
+            char* const endp = writeCode(buf, code);
+            *endp = '\n';
+            m_text.append(buf, endp - buf + 1);
+        }
+    }
+};
+
+//######################################################################
+// VtcTop - Convert a raw trace file
+
+class VtcTop {
+    VtcOptions& m_opt;  // Options
+    VtcInput m_input;  // File being converted
+
+    size_t headerEnd() const {
+        // Return offset after the VCD header text
+        static const char* const endp = "$enddefinitions $end\n\n\n";
+        const char* const datap = m_input.datap();
+        const size_t len = strlen(endp);
+        for (size_t pos = 0; pos + len <= m_input.size(); ++pos) {
+            if (datap[pos] == '$' && 0 == memcmp(datap + pos, endp, len)) return pos + len;
+        }
+        v3fatal(m_opt.m_readFile << ": Raw trace file header is incomplete");
+        return 0;
+    }
+
+    void splitChunks(size_t begin, std::vector<VtcChunk>& chunks) const {
+        // Split records at time changes, about every VTC_CHUNK_BYTES
+        const char* const datap = m_input.datap();
+        const size_t size = m_input.size();
+        size_t chunkBegin = begin;
+        size_t pos = begin;
+        while (pos + 8 <= size) {
+            vluint32_t rec[2];
+            memcpy(rec, datap + pos, sizeof(rec));
+            size_t recSize;
+            if (rec[0] == 0) {
+                if (pos - chunkBegin >= VTC_CHUNK_BYTES) {
+                    chunks.push_back(VtcChunk(chunkBegin, pos));
+                    chunkBegin = pos;
+                }
+                recSize = 12;
+            } else {
+                recSize = 8 + ((rec[1] & ~VL_TRACE_RAW_REAL) + 31) / 32 * 4;
+            }
+            if (pos + recSize > size) break;
+            pos += recSize;
+        }
+        if (pos != size) {
+            // E.g. simulation was killed while writing
+            std::cerr << "%Warning: " << m_opt.m_readFile
+                      << ": Ignoring truncated final record at offset " << pos << endl;
+        }
+        if (pos > chunkBegin) chunks.push_back(VtcChunk(chunkBegin, pos));
+    }
+
+public:
+    explicit VtcTop(VtcOptions& opt)
+        : m_opt(opt) {}
+
+    void convert() {
+        m_input.read(m_opt.m_readFile);
+        const char* const datap = m_input.datap();
+        const size_t magicLen = strlen(VL_TRACE_RAW_MAGIC);
+        if (m_input.size() < magicLen || 0 != memcmp(datap, VL_TRACE_RAW_MAGIC, magicLen)) {
+            v3fatal(m_opt.m_readFile << ": Not a raw trace file (missing "
+                                     << "VLTRACE1 header), was it written to a .vtr file?");
+        }
+        const size_t hdrEnd = headerEnd();
+        const size_t recBegin = (hdrEnd + 3) & ~static_cast<size_t>(3);
+
+        std::vector<VtcChunk> chunks;
+        splitChunks(recBegin, chunks);
+        UINFO(1, "Converting " << chunks.size() << " chunks with " << m_opt.m_threads
+                               << " threads\n");
+
+        std::ofstream os(m_opt.m_writeFile.c_str(), std::ios::out | std::ios::binary);
+        if (!os) v3fatal("Can't write " << m_opt.m_writeFile);
+        os.write(datap + magicLen, hdrEnd - magicLen);
+        // Format a batch of chunks in parallel, then write them in order,
+        // so only one batch of output is in memory at a time
+        for (size_t first = 0; first < chunks.size(); first += m_opt.m_threads) {
+            const size_t last = std::min(chunks.size(), first + m_opt.m_threads);
+#if __cplusplus >= 201103L
+            std::vector<std::thread> threads;
+            for (size_t i = first + 1; i < last; ++i) {
+                threads.push_back(std::thread(&VtcChunk::format, &chunks[i], datap));
+            }
+            chunks[first].format(datap);
+            for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+#else
+            for (size_t i = first; i < last; ++i) chunks[i].format(datap);
+#endif
+            for (size_t i = first; i < last; ++i) {
+                os.write(chunks[i].text().data(), chunks[i].text().size());
+                chunks[i].clear();
+            }
+        }
+        os.close();
+        if (!os) v3fatal("Error writing " << m_opt.m_writeFile);
+    }
+};
+
+//######################################################################
+
+int main(int argc, char** argv, char** /*env*/) {
+    // General initialization
+    std::ios::sync_with_stdio();
+
+    VtcOptions opt;
+
+    // Command option parsing
+    opt.parseOptsList(argc - 1, argv + 1);
+    if (opt.m_readFile.empty() || opt.m_writeFile.empty()) {
+        v3fatal("Usage: verilator_trace_conv [--threads <n>] <input.vtr> <output.vcd>");
+    }
+
+    VtcTop top(opt);
+    top.convert();
+
+    V3Error::abortIfWarnings();
+
+    UINFO(1, "Done, Exiting...\n");
+}
+
+// Local Variables:
+// compile-command: "v4make bin/verilator_trace_conv --debugi 9 obj_dir/simx.vtr simx.vcd"
+// End:
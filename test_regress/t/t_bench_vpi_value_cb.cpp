@@ -0,0 +1,100 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+//
+// Copyright 2020 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#include "Vt_bench_vpi_value_cb.h"
+#include "verilated.h"
+#include "verilated_vpi.h"
+
+#include <cstdio>
+#include <ctime>
+
+// __FILE__ is too long
+#define FILENM "t_bench_vpi_value_cb.cpp"
+
+#define WORDS 10000
+
+unsigned int main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+static int callbacks = 0;
+static int errors = 0;
+
+static PLI_INT32 value_callback(p_cb_data cb_data) {
+    // Word i is written with i+1
+    long index = reinterpret_cast<long>(cb_data->user_data);
+    if (cb_data->value->value.integer != index + 1) {
+        printf("%%Error: %s:%d: word %ld GOT = %d   EXP = %ld\n", FILENM, __LINE__, index,
+               static_cast<int>(cb_data->value->value.integer), index + 1);
+        ++errors;
+    }
+    ++callbacks;
+    return 0;
+}
+
+static void register_callback(vpiHandle memh, long index) {
+    static s_vpi_value v;
+    v.format = vpiIntVal;
+    t_cb_data cb_data;
+    cb_data.reason = cbValueChange;
+    cb_data.cb_rtn = value_callback;
+    cb_data.obj = vpi_handle_by_index(memh, index);
+    cb_data.value = &v;
+    cb_data.time = NULL;
+    cb_data.user_data = reinterpret_cast<PLI_BYTE8*>(index);
+    if (!vpi_register_cb(&cb_data)) {
+        vl_fatal(FILENM, __LINE__, "main", "%Error: vpi_register_cb failed");
+    }
+}
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+
+    VM_PREFIX* topp = new VM_PREFIX("");  // Note null name - we're flattening it out
+
+    topp->eval();
+    topp->clk = 0;
+    main_time += 10;
+
+    vpiHandle memh = vpi_handle_by_name((PLI_BYTE8*)"t.mem", NULL);
+    if (!memh) vl_fatal(FILENM, __LINE__, "main", "%Error: no t.mem");
+    for (long index = 0; index < WORDS; ++index) register_callback(memh, index);
+    // A second callback on the same word
+    register_callback(memh, 0);
+
+    int calls = 0;
+    clock_t cbTime = 0;
+    while (!Verilated::gotFinish() && main_time < 100000) {
+        main_time += 1;
+        topp->eval();
+        clock_t start = clock();
+        VerilatedVpi::callValueCbs();
+        cbTime += clock() - start;
+        ++calls;
+        topp->clk = !topp->clk;
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(FILENM, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+
+    printf("callValueCbs with %d callbacks: %.2f us per call\n", WORDS + 1,
+           1e6 * cbTime / CLOCKS_PER_SEC / calls);
+    // One word written per cycle 0..4000, and word 0 has two callbacks
+    if (callbacks != 4002) {
+        printf("%%Error: %s:%d: callbacks GOT = %d   EXP = %d\n", FILENM, __LINE__, callbacks,
+               4002);
+        ++errors;
+    }
+    if (errors) vl_fatal(FILENM, __LINE__, "main", "%Error: value callbacks failed");
+
+    VL_DO_DANGLING(delete topp, topp);
+    exit(0L);
+}
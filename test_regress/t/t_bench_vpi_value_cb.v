@@ -0,0 +1,30 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// Benchmark of cbValueChange callbacks on every word of a large memory,
+// with one word changing each cycle.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   reg [31:0] mem [0:9999] /*verilator public_flat_rw @(posedge clk) */;
+
+   integer cyc; initial cyc = 0;
+
+   always @ (posedge clk) begin
+      mem[cyc[13:0]] <= cyc + 1;
+      cyc <= cyc + 1;
+      if (cyc == 4000) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,33 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(simulator => 1);
+
+compile(
+    verilator_flags2 => ["--stats"],
+    );
+
+if ($Self->{vlt_all}) {
+    file_grep($Self->{stats}, qr/Optimizations, Cases switched\s+(\d+)/i, 1);
+    # Only the case is a switch, not the user's else-if chain
+    my $found = 0;
+    foreach my $file (glob("$Self->{obj_dir}/*.cpp")) {
+        my $contents = file_contents($file);
+        $found++ while ($contents =~ /switch \(/g);
+    }
+    error("Expected 1 switch statement, found $found") if $found != 1;
+}
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
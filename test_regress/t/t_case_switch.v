@@ -0,0 +1,83 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+   reg [4:0] op = 5'd0;
+   reg [31:0] acc = 32'd0;
+   reg [31:0] acc_ref = 32'd0;
+   reg [31:0] acc2 = 32'd0;
+   reg [31:0] acc2_ref = 32'd0;
+
+   // Dense, complete case; made into a switch
+   always @ (posedge clk) begin
+      case (op)
+        5'd0: acc <= acc + 32'd1;
+        5'd1: acc <= acc + 32'd8;
+        5'd2: acc <= acc + 32'd15;
+        5'd3: acc <= acc + 32'd22;
+        5'd4: acc <= acc + 32'd29;
+        5'd5: acc <= acc + 32'd36;
+        5'd6: acc <= acc + 32'd43;
+        5'd7: acc <= acc + 32'd50;
+        5'd8: acc <= acc + 32'd57;
+        5'd9: acc <= acc + 32'd64;
+        5'd10: acc <= acc + 32'd71;
+        5'd11: acc <= acc + 32'd78;
+        5'd12: acc <= acc + 32'd85;
+        5'd13: acc <= acc + 32'd92;
+        5'd14: acc <= acc + 32'd99;
+        5'd15: acc <= acc + 32'd106;
+        5'd16: acc <= acc + 32'd113;
+        5'd17: acc <= acc + 32'd120;
+        5'd18: acc <= acc + 32'd127;
+        5'd19: acc <= acc + 32'd134;
+        5'd20: acc <= acc + 32'd141;
+        5'd21: acc <= acc + 32'd148;
+        5'd22: acc <= acc + 32'd155;
+        5'd23: acc <= acc + 32'd162;
+        default: acc <= acc + 32'd1000;
+      endcase
+   end
+
+   // User written else-if chain; stays an if/else chain
+   always @ (posedge clk) begin
+      if (op == 5'd0) acc2 <= acc2 + 32'd2;
+      else if (op == 5'd1) acc2 <= acc2 + 32'd7;
+      else if (op == 5'd2) acc2 <= acc2 + 32'd12;
+      else if (op == 5'd3) acc2 <= acc2 + 32'd17;
+      else if (op == 5'd4) acc2 <= acc2 + 32'd22;
+      else if (op == 5'd5) acc2 <= acc2 + 32'd27;
+      else if (op == 5'd6) acc2 <= acc2 + 32'd32;
+      else if (op == 5'd7) acc2 <= acc2 + 32'd37;
+      else if (op == 5'd8) acc2 <= acc2 + 32'd42;
+      else if (op == 5'd9) acc2 <= acc2 + 32'd47;
+      else acc2 <= acc2 + 32'd1000;
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      op <= op + 5'd3;
+      acc_ref <= acc_ref + ((op < 5'd24) ? ({27'd0, op} * 32'd7 + 32'd1) : 32'd1000);
+      acc2_ref <= acc2_ref + ((op < 5'd10) ? ({27'd0, op} * 32'd5 + 32'd2) : 32'd1000);
+`ifdef TEST_VERBOSE
+      $write("[%0t] cyc=%0d op=%0d acc=%x ref=%x\n", $time, cyc, op, acc, acc_ref);
+`endif
+      if (acc != acc_ref) $stop;
+      if (acc2 != acc2_ref) $stop;
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,39 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_cov.h>
+
+#include VM_PREFIX_INCLUDE
+
+VM_PREFIX* topp;
+double main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    Verilated::debug(0);
+    topp = new VM_PREFIX("top");
+
+    topp->clk = false;
+    while (main_time < 1000 && !Verilated::gotFinish()) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        main_time += 5;
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+
+    VerilatedCov::write(VL_STRINGIFY(TEST_OBJ_DIR) "/coverage.dat");
+    VerilatedCov::writeBinary(VL_STRINGIFY(TEST_OBJ_DIR) "/coverage_binary.dat");
+
+    VL_DO_DANGLING(delete topp, topp);
+    exit(0);
+}
@@ -0,0 +1,46 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vltmt => 1);
+
+top_filename("t/t_cover_line.v");
+
+compile(
+    verilator_flags2 => ['--cc --coverage-line +define+ATTRIBUTE'],
+    );
+
+# Each function looks up its thread's counters once, not at every increment
+my $contents = "";
+foreach my $file (glob("$Self->{obj_dir}/*.cpp")) {
+    $contents .= file_contents($file);
+}
+if ($contents !~ /__Vcoverp = vlSymsp->__Vcoverage\[Verilated::threadNum\(\)\];/) {
+    error("Missing per-function coverage row lookup");
+}
+if ($contents =~ /__Vcoverage\[Verilated::threadNum\(\)\]\[/) {
+    error("Coverage increment looks up the thread number");
+}
+
+execute(
+    check_finished => 1,
+    );
+
+# Counts from each thread's shard must add up to the single-threaded counts
+inline_checks();
+
+run(cmd => ["../bin/verilator_coverage",
+            "--annotate", "$Self->{obj_dir}/annotated",
+            "$Self->{obj_dir}/coverage.dat",
+    ]);
+
+files_identical("$Self->{obj_dir}/annotated/t_cover_line.v", "t/t_cover_line.out");
+
+ok(1);
+1;
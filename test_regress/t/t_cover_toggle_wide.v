@@ -0,0 +1,51 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// Toggle coverage of signals wider than a quad, which are checked a word
+// at a time.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc; initial cyc=1;
+
+   reg [99:0] wide; initial wide='0;
+   // CHECK_COVER(-1,"top.t","wide[0]",2)
+   // CHECK_COVER(-2,"top.t","wide[31]",2)
+   // CHECK_COVER(-3,"top.t","wide[32]",2)
+   // CHECK_COVER(-4,"top.t","wide[40]",0)
+   // CHECK_COVER(-5,"top.t","wide[64]",4)
+   // CHECK_COVER(-6,"top.t","wide[99]",2)
+
+   always @ (posedge clk) begin
+      if (cyc!=0) begin
+         cyc <= cyc + 1;
+         if (cyc==3) begin
+            // Every bit except bit 40 rises
+            wide <= ~(100'h1 << 40);
+         end
+         else if (cyc==5) begin
+            // Only the third word changes
+            wide[64] <= 1'b0;
+         end
+         else if (cyc==7) begin
+            wide[64] <= 1'b1;
+         end
+         else if (cyc==9) begin
+            wide <= '0;
+         end
+         else if (cyc==10) begin
+            $write("*-* All Finished *-*\n");
+            $finish;
+         end
+      end
+   end
+
+endmodule
@@ -0,0 +1,58 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    verilator_flags2 => ["--prof-vars"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+my $header = "$Self->{obj_dir}/$Self->{VM_PREFIX}.h";
+my $subheader = "$Self->{obj_dir}/$Self->{VM_PREFIX}_sub.h";
+
+# Without feedback nothing is reordered
+file_grep_not($header, qr/Rarely\ accessed/x);
+
+my $feedback = "$Self->{obj_dir}/vars.dat";
+run(cmd => ["cp", "$Self->{obj_dir}/coverage.dat", $feedback]);
+
+# Recompile using the measured counts; the headers are reread under new names
+compile(
+    verilator_flags2 => ["--stats --var-feedback $feedback"],
+    );
+run(cmd => ["cp", $header, "$header.feedback"]);
+run(cmd => ["cp", $subheader, "$subheader.feedback"]);
+$header .= ".feedback";
+$subheader .= ".feedback";
+
+file_grep($Self->{stats}, qr/Optimizations, Variables measured cold\s+[1-9]/i);
+
+# Variables used every eval come before those never or only once used
+file_grep($header,
+          qr/\bt__DOT__hot_sum;.*Rarely\ accessed.*\bt__DOT__cold_seed;/sx);
+file_grep($header,
+          qr/\bt__DOT__hot_sum;.*Rarely\ accessed.*\bt__DOT__err_count;/sx);
+file_grep_not($header, qr/Rarely\ accessed.*\bt__DOT__hot_sum;/sx);
+file_grep($subheader, qr/\bsub_sum;.*Rarely\ accessed.*\bsub_rare;/sx);
+
+# Ports keep their declared order, even when rarely accessed
+file_grep($subheader, qr/\brare_in\b.*\bhot_in\b/sx);
+file_grep_not($subheader, qr/Rarely\ accessed.*\brare_in\b/sx);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
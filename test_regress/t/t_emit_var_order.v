@@ -0,0 +1,63 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// Variables that --prof-vars measured as rarely accessed are laid out
+// after the others, except ports, which keep their order.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc; initial cyc = 0;
+   reg [31:0] hot_sum; initial hot_sum = 0;
+   reg [31:0] cold_seed; initial cold_seed = $random | 1;
+   reg [31:0] err_count; initial err_count = 0;
+
+   sub sub (.clk, .rare_in(cold_seed), .hot_in(hot_sum));
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      hot_sum <= hot_sum + cyc;
+      if (hot_sum == 32'hffff_fffe) begin
+         err_count <= err_count + 1;
+      end
+      if (cyc == 9) begin
+         if (hot_sum != 36) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+   final if (cold_seed == 0 || err_count != 0) $stop;
+
+endmodule
+
+module sub (/*AUTOARG*/
+   // Inputs
+   clk, rare_in, hot_in
+   );
+   /*verilator no_inline_module*/
+
+   input clk;
+   input [31:0] rare_in;  // Only read by a branch never taken, but a port
+   input [31:0] hot_in;
+
+   reg [31:0] sub_sum; initial sub_sum = 0;
+   reg [31:0] sub_rare; initial sub_rare = 0;
+
+   always @ (posedge clk) begin
+      sub_sum <= sub_sum + hot_in;
+      if (hot_in == 32'hffff_fffe) begin
+         sub_rare <= rare_in;
+      end
+   end
+
+   final if (sub_rare != 0 || sub_sum == 32'hffff_fffe) $stop;
+
+endmodule
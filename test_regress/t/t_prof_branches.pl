@@ -0,0 +1,52 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+# Only --prof-branches, so branch points must not rely on line coverage
+compile(
+    verilator_flags2 => ["--prof-branches"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Read the input .v file and do any CHECK_COVER requests
+inline_checks();
+
+my $feedback = "$Self->{obj_dir}/branches.dat";
+run(cmd => ["cp", "$Self->{obj_dir}/coverage.dat", $feedback]);
+
+# Recompile using the measured counts
+compile(
+    verilator_flags2 => ["--stats --branch-feedback $feedback"],
+    );
+
+file_grep($Self->{stats}, qr/Optimizations, Branch feedback hints\s+[1-9]/i);
+
+# Each measured branch has the hint for its own direction
+my $contents = "";
+foreach my $file (glob("$Self->{obj_dir}/*.cpp")) {
+    $contents .= file_contents($file);
+}
+foreach my $re (qr/VL_UNLIKELY\(\(5U? == [^)]*cyc\)\)/,
+                qr/VL_LIKELY\(\(5U? != [^)]*cyc\)\)/,
+                qr/VL_UNLIKELY\(\(3U? == [^)]*cyc\)\)/,
+                qr/VL_LIKELY\(\(7U? != [^)]*cyc\)\)/) {
+    error("Expected branch hint not found: $re") if $contents !~ $re;
+}
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,53 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+   integer rare = 0;
+   integer common = 0;
+   integer rare2 = 0;
+   integer common2 = 0;
+   integer inarm = 0;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 5) begin
+         // CHECK_COVER(-1,"top.t","taken",1)
+         rare <= rare + 1;
+      end
+      if (cyc != 5) begin
+         // CHECK_COVER(-1,"top.t","not_taken",1)
+         common <= common + 1;
+      end
+      // Opposite branches on one line, which get separate hints
+      if (cyc == 3) rare2 <= rare2 + 1; if (cyc != 7) common2 <= common2 + 1;
+      // Branches in a case arm are counted without --coverage-line
+      case (cyc[1:0])
+        2'd1: begin
+           if (cyc == 9) inarm <= inarm + 1;
+           // CHECK_COVER(-1,"top.t","taken",1)
+           // CHECK_COVER(-2,"top.t","not_taken",24)
+        end
+        default: ;
+      endcase
+      if (cyc == 99) begin
+         if (rare != 1) $stop;
+         if (common != 98) $stop;
+         if (rare2 != 1) $stop;
+         if (common2 != 98) $stop;
+         if (inarm != 1) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,72 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_save.h>
+
+#include VM_PREFIX_INCLUDE
+
+VM_PREFIX* topp;
+double main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+static const char* filenamep = VL_STRINGIFY(TEST_OBJ_DIR) "/saved.vltsv";
+static int saves_done = 0;
+
+static void save_cb(VerilatedSave& os, void* userp) {
+    os << main_time;
+    os << *topp;
+}
+
+static void done_cb(const char* fnp, bool ok, double stallSecs, double totalSecs, void* userp) {
+    if (!ok) vl_fatal(__FILE__, __LINE__, "main", "%Error: Background save failed");
+    if (stallSecs > totalSecs) vl_fatal(__FILE__, __LINE__, "main", "%Error: Bad save times");
+    ++saves_done;
+}
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    Verilated::debug(0);
+    srand48(5);  // Ensure determinism
+    topp = new VM_PREFIX("top");
+    topp->eval();
+
+    VerilatedSaveAsync saver;
+    saver.doneCb(done_cb, NULL);
+    bool restore = Verilated::commandArgsPlusMatch("save_restore=")[0] != '\0';
+
+    if (restore) {
+        VL_PRINTF("Restoring model from '%s'\n", filenamep);
+        VerilatedRestore os;
+        os.open(filenamep);
+        os >> main_time;
+        os >> *topp;
+        os.close();
+    } else {
+        topp->clk = false;
+        main_time += 10;
+    }
+    while (main_time < 1100 && !Verilated::gotFinish()) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        main_time += 5;
+        // Simulation continues, and changes the model, while the save is written
+        if (!restore && main_time == 500) saver.save(filenamep, save_cb, NULL);
+        saver.poll();
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+    saver.wait();
+    if (saves_done != (restore ? 0 : 1)) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Save not reported as done");
+    }
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
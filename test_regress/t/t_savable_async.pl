@@ -0,0 +1,34 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_savable.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--cc --savable --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+# Saves in the background at time 500 and runs on to the $finish
+execute(
+    check_finished => 1,
+    );
+
+-r "$Self->{obj_dir}/saved.vltsv" or error("saved.vltsv not created\n");
+
+execute(
+    all_run_flags => ['+save_restore=1'],
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,70 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_save.h>
+
+#include VM_PREFIX_INCLUDE
+
+VM_PREFIX* topp;
+double main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+static const char* basenamep = VL_STRINGIFY(TEST_OBJ_DIR) "/base.vltsv";
+static const char* deltanamep = VL_STRINGIFY(TEST_OBJ_DIR) "/delta.vltsv";
+static const char* movednamep = VL_STRINGIFY(TEST_OBJ_DIR) "/moved/delta.vltsv";
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    Verilated::debug(0);
+    srand48(5);  // Ensure determinism
+    topp = new VM_PREFIX("top");
+    topp->eval();
+
+    VerilatedSaveDelta saver;
+    bool restore = Verilated::commandArgsPlusMatch("save_restore=")[0] != '\0';
+
+    if (restore) {
+        // +moved restores after the .pl moved both checkpoints elsewhere
+        const char* filenamep
+            = Verilated::commandArgsPlusMatch("moved")[0] != '\0' ? movednamep : deltanamep;
+        VL_PRINTF("Restoring model from '%s'\n", filenamep);
+        VerilatedRestore os;
+        os.open(filenamep);
+        os >> main_time;
+        os >> *topp;
+        os.close();
+    } else {
+        topp->clk = false;
+        main_time += 10;
+    }
+    while (main_time < 1100 && !Verilated::gotFinish()) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        main_time += 5;
+        if (!restore && (main_time == 300 || main_time == 500)) {
+            saver.open(main_time == 300 ? basenamep : deltanamep);
+            if (saver.writingBase() != (main_time == 300)) {
+                vl_fatal(__FILE__, __LINE__, "main", "%Error: Unexpected checkpoint kind");
+            }
+            saver << main_time;
+            saver << *topp;
+            saver.close();
+            if (main_time == 500) {
+                VL_PRINTF("Exiting after save_model\n");
+                exit(0);
+            }
+        }
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
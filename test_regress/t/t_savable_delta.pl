@@ -0,0 +1,59 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_savable.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--cc --savable --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+# Writes a base checkpoint at time 300 and a delta at 500
+execute(
+    check_finished => 0,
+    );
+
+-r "$Self->{obj_dir}/base.vltsv" or error("base.vltsv not created\n");
+-r "$Self->{obj_dir}/delta.vltsv" or error("delta.vltsv not created\n");
+
+# Restores from the delta, which reads unchanged data from the base
+execute(
+    all_run_flags => ['+save_restore=1'],
+    check_finished => 1,
+    );
+
+# Moving both checkpoints finds the base beside the delta
+mkdir "$Self->{obj_dir}/moved";
+rename("$Self->{obj_dir}/base.vltsv", "$Self->{obj_dir}/moved/base.vltsv");
+rename("$Self->{obj_dir}/delta.vltsv", "$Self->{obj_dir}/moved/delta.vltsv");
+execute(
+    all_run_flags => ['+save_restore=1 +moved'],
+    check_finished => 1,
+    );
+
+# A base rewritten with the same length is rejected
+{
+    my $filename = "$Self->{obj_dir}/moved/base.vltsv";
+    my $data = file_contents($filename);
+    my $pos = int(length($data) / 2);
+    substr($data, $pos, 1) = chr(ord(substr($data, $pos, 1)) ^ 0xff);
+    write_wholefile($filename, $data);
+}
+execute(
+    all_run_flags => ['+save_restore=1 +moved'],
+    fails => 1,
+    expect => qr/has changed since delta file was made/,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,61 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_save.h>
+
+#include VM_PREFIX_INCLUDE
+
+VM_PREFIX* topp;
+double main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+static void run() {
+    while (main_time < 1100 && !Verilated::gotFinish()) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        main_time += 5;
+        if (main_time == 500) return;
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+}
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    Verilated::debug(0);
+    srand48(5);  // Ensure determinism
+    topp = new VM_PREFIX("top");
+    topp->eval();
+
+    topp->clk = false;
+    main_time += 10;
+    run();  // Up to time 500
+
+    VerilatedSaveMem snapshot;
+    snapshot.open();
+    snapshot << main_time;
+    snapshot << *topp;
+    snapshot.close();
+
+    // Each continuation rewinds to the snapshot and runs to the $finish
+    for (int cont = 0; cont < 3; ++cont) {
+        VL_PRINTF("Continuation %d\n", cont);
+        VerilatedRestoreMem os;
+        os.open(snapshot);
+        os >> main_time;
+        os >> *topp;
+        os.close();
+        Verilated::gotFinish(false);
+        run();
+    }
+    topp->final();
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
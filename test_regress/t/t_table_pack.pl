@@ -0,0 +1,58 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+sub table_lines {
+    # Per-cycle output values, without the driver's own messages
+    my $contents = file_contents(shift);
+    return join('', grep { /^[0-9a-f]+ [0-9a-f]+ [0-9a-f]+ [0-9a-f]+ [0-9a-f]+$/ }
+                split(/^/m, $contents));
+}
+
+compile(
+    verilator_flags2 => ["--stats"],
+    );
+
+# Files are renamed before recompiling, as file_contents caches by name
+run(cmd => ["mv", $Self->{stats}, "$Self->{obj_dir}/table_stats.txt"]);
+file_grep("$Self->{obj_dir}/table_stats.txt", qr/Optimizations, Tables created\s+(\d+)/i, 1);
+file_grep("$Self->{obj_dir}/table_stats.txt", qr/Optimizations, Tables packed\s+(\d+)/i, 1);
+
+my $contents = "";
+foreach my $file (glob("$Self->{obj_dir}/*.cpp")) {
+    $contents .= file_contents($file);
+}
+error("No __Vtablepack table emitted") if $contents !~ /__Vtablepack1/;
+
+execute(
+    check_finished => 1,
+    );
+
+run(cmd => ["mv", $Self->{run_log_filename}, "$Self->{obj_dir}/table.log"]);
+
+# Same design without tables must give the same outputs
+compile(
+    verilator_flags2 => ["--stats -fno-table"],
+    );
+
+file_grep_not($Self->{stats}, qr/Optimizations, Tables created\s+[1-9]/i);
+
+execute(
+    check_finished => 1,
+    );
+
+my $table = table_lines("$Self->{obj_dir}/table.log");
+my $notable = table_lines($Self->{run_log_filename});
+error("No table outputs logged") if $table eq "";
+error("Packed table outputs differ from -fno-table") if $table ne $notable;
+
+ok(1);
+1;
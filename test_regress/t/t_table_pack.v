@@ -0,0 +1,118 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// Several outputs of different widths that V3Table packs into one table
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+   reg [5:0] index = 6'h0;
+
+   reg        outa;
+   reg [6:0]  outb;
+   reg [12:0] outc;
+   reg [30:0] outd;
+
+   // Same values as the table, computed without one
+   wire        refa = ^index;
+   wire [6:0]  refb = {1'b0, index} * 7'd37;
+   wire [12:0] refc = {index, index ^ 6'h2a, index[0]};
+   wire [30:0] refd = ({25'h0, index} * 31'h01234567) ^ 31'h55aa33cc;
+
+   // Created from python
+   // for i in range(64): a = parity(i); b = (i * 37) & 0x7f;
+   //   c = (i << 7) | ((i ^ 0x2a) << 1) | (i & 1); d = ((i * 0x01234567) ^ 0x55aa33cc) & 0x7fffffff
+   always @(/*AS*/index) begin
+      case (index)
+        6'h00: begin outa = 1'b0; outb = 7'h00; outc = 13'h0054; outd = 31'h55aa33cc; end
+        6'h01: begin outa = 1'b1; outb = 7'h25; outc = 13'h00d7; outd = 31'h548976ab; end
+        6'h02: begin outa = 1'b1; outb = 7'h4a; outc = 13'h0150; outd = 31'h57ecb902; end
+        6'h03: begin outa = 1'b0; outb = 7'h6f; outc = 13'h01d3; outd = 31'h56c3e3f9; end
+        6'h04: begin outa = 1'b1; outb = 7'h14; outc = 13'h025c; outd = 31'h51272650; end
+        6'h05: begin outa = 1'b0; outb = 7'h39; outc = 13'h02df; outd = 31'h501a68cf; end
+        6'h06: begin outa = 1'b0; outb = 7'h5e; outc = 13'h0358; outd = 31'h537993a6; end
+        6'h07: begin outa = 1'b1; outb = 7'h03; outc = 13'h03db; outd = 31'h525cd61d; end
+        6'h08: begin outa = 1'b1; outb = 7'h28; outc = 13'h0444; outd = 31'h5cb018f4; end
+        6'h09: begin outa = 1'b0; outb = 7'h4d; outc = 13'h04c7; outd = 31'h5f974353; end
+        6'h0a: begin outa = 1'b0; outb = 7'h72; outc = 13'h0540; outd = 31'h5eca85ca; end
+        6'h0b: begin outa = 1'b1; outb = 7'h17; outc = 13'h05c3; outd = 31'h5929c8a1; end
+        6'h0c: begin outa = 1'b0; outb = 7'h3c; outc = 13'h064c; outd = 31'h580d7318; end
+        6'h0d: begin outa = 1'b1; outb = 7'h61; outc = 13'h06cf; outd = 31'h5b60b5f7; end
+        6'h0e: begin outa = 1'b1; outb = 7'h06; outc = 13'h0748; outd = 31'h5a47f86e; end
+        6'h0f: begin outa = 1'b0; outb = 7'h2b; outc = 13'h07cb; outd = 31'h44bb22c5; end
+        6'h10: begin outa = 1'b1; outb = 7'h50; outc = 13'h0874; outd = 31'h479e65bc; end
+        6'h11: begin outa = 1'b0; outb = 7'h75; outc = 13'h08f7; outd = 31'h46fda81b; end
+        6'h12: begin outa = 1'b0; outb = 7'h1a; outc = 13'h0970; outd = 31'h41d0d2f2; end
+        6'h13: begin outa = 1'b1; outb = 7'h3f; outc = 13'h09f3; outd = 31'h40341569; end
+        6'h14: begin outa = 1'b0; outb = 7'h64; outc = 13'h0a7c; outd = 31'h436b5fc0; end
+        6'h15: begin outa = 1'b1; outb = 7'h09; outc = 13'h0aff; outd = 31'h424e82bf; end
+        6'h16: begin outa = 1'b1; outb = 7'h2e; outc = 13'h0b78; outd = 31'h4cadc516; end
+        6'h17: begin outa = 1'b0; outb = 7'h53; outc = 13'h0bfb; outd = 31'h4f810f8d; end
+        6'h18: begin outa = 1'b0; outb = 7'h78; outc = 13'h0c64; outd = 31'h4ee4b264; end
+        6'h19: begin outa = 1'b1; outb = 7'h1d; outc = 13'h0ce7; outd = 31'h49dbf4c3; end
+        6'h1a: begin outa = 1'b1; outb = 7'h42; outc = 13'h0d60; outd = 31'h483f3fba; end
+        6'h1b: begin outa = 1'b0; outb = 7'h67; outc = 13'h0de3; outd = 31'h4b126211; end
+        6'h1c: begin outa = 1'b1; outb = 7'h0c; outc = 13'h0e6c; outd = 31'h4a71a488; end
+        6'h1d: begin outa = 1'b0; outb = 7'h31; outc = 13'h0eef; outd = 31'h7554ef67; end
+        6'h1e: begin outa = 1'b0; outb = 7'h56; outc = 13'h0f68; outd = 31'h778811de; end
+        6'h1f: begin outa = 1'b1; outb = 7'h7b; outc = 13'h0feb; outd = 31'h76ef54b5; end
+        6'h20: begin outa = 1'b1; outb = 7'h20; outc = 13'h1014; outd = 31'h71c29f2c; end
+        6'h21: begin outa = 1'b0; outb = 7'h45; outc = 13'h1097; outd = 31'h7021c18b; end
+        6'h22: begin outa = 1'b0; outb = 7'h6a; outc = 13'h1110; outd = 31'h73050462; end
+        6'h23: begin outa = 1'b1; outb = 7'h0f; outc = 13'h1193; outd = 31'h72784ed9; end
+        6'h24: begin outa = 1'b0; outb = 7'h34; outc = 13'h121c; outd = 31'h7d5ff1b0; end
+        6'h25: begin outa = 1'b1; outb = 7'h59; outc = 13'h129f; outd = 31'h7fb3342f; end
+        6'h26: begin outa = 1'b1; outb = 7'h7e; outc = 13'h1318; outd = 31'h7e967e86; end
+        6'h27: begin outa = 1'b0; outb = 7'h23; outc = 13'h139b; outd = 31'h79f5a17d; end
+        6'h28: begin outa = 1'b0; outb = 7'h48; outc = 13'h1404; outd = 31'h7828ebd4; end
+        6'h29: begin outa = 1'b1; outb = 7'h6d; outc = 13'h1487; outd = 31'h7b0c2eb3; end
+        6'h2a: begin outa = 1'b1; outb = 7'h12; outc = 13'h1500; outd = 31'h7a63512a; end
+        6'h2b: begin outa = 1'b0; outb = 7'h37; outc = 13'h1583; outd = 31'h65469b81; end
+        6'h2c: begin outa = 1'b1; outb = 7'h5c; outc = 13'h160c; outd = 31'h67a5de78; end
+        6'h2d: begin outa = 1'b0; outb = 7'h01; outc = 13'h168f; outd = 31'h669900d7; end
+        6'h2e: begin outa = 1'b0; outb = 7'h26; outc = 13'h1708; outd = 31'h61fc4b4e; end
+        6'h2f: begin outa = 1'b1; outb = 7'h4b; outc = 13'h178b; outd = 31'h60d38e25; end
+        6'h30: begin outa = 1'b0; outb = 7'h70; outc = 13'h1834; outd = 31'h6337309c; end
+        6'h31: begin outa = 1'b1; outb = 7'h15; outc = 13'h18b7; outd = 31'h626a7b7b; end
+        6'h32: begin outa = 1'b1; outb = 7'h3a; outc = 13'h1930; outd = 31'h6d49bdd2; end
+        6'h33: begin outa = 1'b0; outb = 7'h5f; outc = 13'h19b3; outd = 31'h6face049; end
+        6'h34: begin outa = 1'b1; outb = 7'h04; outc = 13'h1a3c; outd = 31'h6e802b20; end
+        6'h35: begin outa = 1'b0; outb = 7'h29; outc = 13'h1abf; outd = 31'h69e76d9f; end
+        6'h36: begin outa = 1'b0; outb = 7'h4e; outc = 13'h1b38; outd = 31'h68da9076; end
+        6'h37: begin outa = 1'b1; outb = 7'h73; outc = 13'h1bbb; outd = 31'h6b39daed; end
+        6'h38: begin outa = 1'b1; outb = 7'h18; outc = 13'h1c24; outd = 31'h6a1d1d44; end
+        6'h39: begin outa = 1'b0; outb = 7'h3d; outc = 13'h1ca7; outd = 31'h15704023; end
+        6'h3a: begin outa = 1'b0; outb = 7'h62; outc = 13'h1d20; outd = 31'h14578a9a; end
+        6'h3b: begin outa = 1'b1; outb = 7'h07; outc = 13'h1da3; outd = 31'h168acd71; end
+        6'h3c: begin outa = 1'b0; outb = 7'h2c; outc = 13'h1e2c; outd = 31'h11ee77e8; end
+        6'h3d: begin outa = 1'b1; outb = 7'h51; outc = 13'h1eaf; outd = 31'h10cdba47; end
+        6'h3e: begin outa = 1'b1; outb = 7'h76; outc = 13'h1f28; outd = 31'h1320fd3e; end
+        6'h3f: begin outa = 1'b0; outb = 7'h1b; outc = 13'h1fab; outd = 31'h12042795; end
+        default: begin outa = 1'b0; outb = 7'h0; outc = 13'h0; outd = 31'h0; end
+      endcase
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      // Visit every entry, out of order
+      index <= index + 6'd29;
+`ifdef TEST_VERBOSE
+      $write("[%0t] cyc=%0d index=%x a=%x b=%x c=%x d=%x\n",
+             $time, cyc, index, outa, outb, outc, outd);
+`endif
+      $write("%x %x %x %x %x\n", index, outa, outb, outc, outd);
+      if ({outa, outb, outc, outd} != {refa, refb, refc, refd}) $stop;
+      if (cyc == 70) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,40 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+# Reference: every element traced each dump, so above the default limit
+compile(
+    verilator_flags2 => ['--cc --trace --trace-max-array 256'],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+my $golden_vcd = "$Self->{obj_dir}/simx_full.vcd";
+run(cmd => ["cp", "$Self->{obj_dir}/simx.vcd", $golden_vcd]);
+
+# Write tracked, with the default --trace-max-array below the memory depth
+compile(
+    verilator_flags2 => ['--cc --trace --trace-array-writes --stats'],
+    );
+
+file_grep($Self->{stats}, qr/Tracing, Write tracked arrays\s+1\b/i);
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/simx.vcd", qr/ mem\(199\) /);
+vcd_identical("$Self->{obj_dir}/simx.vcd", $golden_vcd);
+
+ok(1);
+1;
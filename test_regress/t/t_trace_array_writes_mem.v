@@ -0,0 +1,66 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// A memory larger than --trace-max-array, written sparsely, in bursts
+// within one 64 element block, and all at once by $readmemh.
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   integer i;
+
+   reg [15:0] mem [0:199];
+
+   initial begin
+      for (i = 0; i < 200; i = i + 1) mem[i] = 16'h0;
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 1) begin
+         // Sparse writes, in different blocks
+         mem[3] <= 16'h0003;
+         mem[150] <= 16'h0150;
+      end
+      else if (cyc == 2) begin
+         // Several writes to the same block
+         mem[64] <= 16'h0064;
+         mem[65] <= 16'h0065;
+         mem[100] <= 16'h0100;
+         mem[127] <= 16'h0127;
+      end
+      else if (cyc == 3) begin
+         // Flags every element
+         $readmemh("t/t_trace_array_writes_mem.mem", mem);
+      end
+      else if (cyc == 4) begin
+         // First and last (partial) blocks; mem[5] is rewritten unchanged
+         mem[0] <= 16'hf000;
+         mem[5] <= mem[5];
+         mem[199] <= 16'hf199;
+      end
+      else if (cyc == 5) begin
+         // Variable index, across blocks
+         mem[cyc * 30] <= 16'hf150;
+         mem[cyc * 12 + 3] <= 16'hf063;
+      end
+      else if (cyc == 7) begin
+         if (mem[0] != 16'hf000) $stop;
+         if (mem[5] != 16'hb005) $stop;
+         if (mem[63] != 16'hf063) $stop;
+         if (mem[64] != 16'hb064) $stop;
+         if (mem[100] != 16'h0100) $stop;
+         if (mem[150] != 16'hf150) $stop;
+         if (mem[199] != 16'hf199) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
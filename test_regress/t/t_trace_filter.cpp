@@ -0,0 +1,53 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#ifdef TEST_FST
+# include <verilated_fst_c.h>
+#else
+# include <verilated_vcd_c.h>
+#endif
+
+#include VM_PREFIX_INCLUDE
+
+unsigned long long main_time = 0;
+double sc_time_stamp() { return (double)main_time; }
+
+int main(int argc, char** argv, char** env) {
+    VM_PREFIX* top = new VM_PREFIX("top");
+
+    Verilated::debug(0);
+    Verilated::traceEverOn(true);
+
+#ifdef TEST_FST
+    VerilatedFstC* tfp = new VerilatedFstC;
+#else
+    VerilatedVcdC* tfp = new VerilatedVcdC;
+#endif
+    top->trace(tfp, 99);
+    tfp->traceInclude("top.t.u_*");
+    tfp->traceExclude("top.t.u_drop");
+    tfp->traceExclude("*.drop_cnt");
+#ifdef TEST_FST
+    tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simx.fst");
+#else
+    tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simx.vcd");
+#endif
+
+    top->clk = 0;
+
+    while (main_time < 100 && !Verilated::gotFinish()) {
+        top->clk = !top->clk;
+        top->eval();
+        tfp->dump((unsigned int)(main_time));
+        ++main_time;
+    }
+    tfp->close();
+    top->final();
+    return 0;
+}
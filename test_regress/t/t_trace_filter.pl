@@ -0,0 +1,30 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--trace --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/simx.vcd", qr/scope module u_keep /);
+file_grep("$Self->{obj_dir}/simx.vcd", qr/ keep_cnt \[7:0\]/);
+file_grep("$Self->{obj_dir}/simx.vcd", qr/^b00001111 /m);
+file_grep_not("$Self->{obj_dir}/simx.vcd", qr/u_drop/);
+file_grep_not("$Self->{obj_dir}/simx.vcd", qr/drop_cnt/);
+
+ok(1);
+1;
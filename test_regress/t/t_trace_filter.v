@@ -0,0 +1,41 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+
+   sub u_keep (.clk(clk), .cyc(cyc));
+   sub u_drop (.clk(clk), .cyc(cyc));
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 9) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
+
+module sub (/*AUTOARG*/
+   // Inputs
+   clk, cyc
+   );
+   input clk;
+   input integer cyc;
+
+   reg [7:0] keep_cnt = 0;
+   reg [7:0] drop_cnt = 0;
+
+   always @ (posedge clk) begin
+      keep_cnt <= keep_cnt + 8'd3;
+      drop_cnt <= drop_cnt + 8'd5;
+   end
+endmodule
@@ -0,0 +1,29 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_trace_filter.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--trace-fst -CFLAGS -DTEST_FST --exe $Self->{t_dir}/t_trace_filter.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Only u_keep, without drop_cnt; u_drop's and t's own signals are not declared
+fst_identical("$Self->{obj_dir}/simx.fst", $Self->{golden_filename});
+
+ok(1);
+1;
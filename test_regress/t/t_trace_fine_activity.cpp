@@ -0,0 +1,58 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_vcd_c.h>
+
+#include VM_PREFIX_INCLUDE
+
+unsigned long long main_time = 0;
+double sc_time_stamp() { return (double)main_time; }
+
+int main(int argc, char** argv, char** env) {
+    VM_PREFIX* top = new VM_PREFIX("top");
+
+    Verilated::debug(0);
+    Verilated::traceEverOn(true);
+
+    VerilatedVcdC* tfp = new VerilatedVcdC;
+    top->trace(tfp, 99);
+    tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simx.vcd");
+
+    top->clk = 0;
+
+    while (main_time < 1000 && !Verilated::gotFinish()) {
+        top->clk = !top->clk;
+        top->eval();
+        tfp->dump((unsigned int)(main_time));
+        ++main_time;
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+
+    VL_PRINTF("dumps=%" VL_PRI64 "u checked=%" VL_PRI64 "u changed=%" VL_PRI64 "u\n",
+              tfp->statDumps(), tfp->statChecked(), tfp->statChanged());
+#ifdef VL_TRACE_STATS
+    if (tfp->statChanged() == 0) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: No changed signals counted");
+    }
+    if (tfp->statChecked() < tfp->statChanged()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Fewer signals checked than changed");
+    }
+#else
+    // Not counted without --trace-fine-activity
+    if (tfp->statChecked() || tfp->statChanged()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Signals counted without VL_TRACE_STATS");
+    }
+#endif
+
+    tfp->close();
+    top->final();
+    return 0;
+}
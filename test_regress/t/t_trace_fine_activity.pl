@@ -0,0 +1,64 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_trace_complex.v");
+
+sub activity_codes {
+    # Renamed first, as file_contents caches by name and we compile twice
+    my $filename = "$Self->{obj_dir}/" . shift;
+    run(cmd => ["mv", $Self->{stats}, $filename]);
+    my $contents = file_contents($filename);
+    if ($contents !~ /Tracing, Activity codes\s+(\d+)/i) {
+        error("No activity code statistic in $filename");
+        return 0;
+    }
+    return $1;
+}
+
+# Default build, for comparison; doesn't count signals
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--cc --trace --stats --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+my $coarse = activity_codes("coarse_stats.txt");
+
+execute(
+    check_finished => 1,
+    );
+
+run(cmd => ["mv", "$Self->{obj_dir}/simx.vcd", "$Self->{obj_dir}/simx_coarse.vcd"]);
+# Runtime objects must be rebuilt with VL_TRACE_STATS
+run(cmd => ["rm", "-f", glob("$Self->{obj_dir}/verilated*.o")]);
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--cc --trace --trace-fine-activity --stats"
+                         ." --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+my $fine = activity_codes("fine_stats.txt");
+error("Expected more activity codes with --trace-fine-activity, got $fine vs $coarse")
+    if $fine <= $coarse;
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/$Self->{VM_PREFIX}.mk", qr/^VM_TRACE_STATS = 1$/m);
+
+vcd_identical("$Self->{obj_dir}/simx.vcd", "$Self->{obj_dir}/simx_coarse.vcd");
+
+ok(1);
+1;
@@ -0,0 +1,52 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_vcd_c.h>
+
+#include <cstdio>
+
+#include VM_PREFIX_INCLUDE
+
+static const char* filenamep = VL_STRINGIFY(TEST_OBJ_DIR) "/simx.vcd";
+
+unsigned long long main_time = 0;
+double sc_time_stamp() { return (double)main_time; }
+
+int main(int argc, char** argv, char** env) {
+    VM_PREFIX* top = new VM_PREFIX("top");
+
+    Verilated::debug(0);
+    Verilated::traceEverOn(true);
+
+    VerilatedVcdC* tfp = new VerilatedVcdC;
+    top->trace(tfp, 99);
+    tfp->flightRecorder(1, 2);  // Keep two 1KB segments
+    remove(filenamep);
+    tfp->open(filenamep);
+
+    top->clk = 0;
+
+    while (main_time < 10000 && !Verilated::gotFinish()) {
+        top->clk = !top->clk;
+        top->eval();
+        tfp->dump((unsigned int)(main_time));
+        if (main_time == 500) {
+            // A plain flush keeps the window in memory
+            tfp->flush();
+            if (FILE* fp = fopen(filenamep, "r")) {
+                fclose(fp);
+                vl_fatal(__FILE__, __LINE__, "main", "%Error: flush() wrote the window");
+            }
+        }
+        ++main_time;
+    }
+    tfp->close();  // Writes the window
+    top->final();
+    return 0;
+}
@@ -0,0 +1,46 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_fst_c.h>
+
+#include VM_PREFIX_INCLUDE
+
+double main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    Verilated::debug(0);
+    srand48(5);  // Ensure determinism
+    VM_PREFIX* topp = new VM_PREFIX("top");
+    topp->eval();
+
+    // Same timing as the driver's default main, so matches its golden file
+    Verilated::traceEverOn(true);
+    VerilatedFstC* tfp = new VerilatedFstC;
+    topp->trace(tfp, 99);
+    tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simx.fst", 4);
+    tfp->dump(main_time);
+
+    topp->clk = false;
+    main_time += 10;
+    while (main_time < 1100 && !Verilated::gotFinish()) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        tfp->dump(main_time);
+        main_time += 5;
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+    tfp->close();
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
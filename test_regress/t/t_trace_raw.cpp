@@ -0,0 +1,50 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_vcd_c.h>
+
+#include VM_PREFIX_INCLUDE
+
+unsigned long long main_time = 0;
+double sc_time_stamp() { return (double)main_time; }
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    VM_PREFIX* top = new VM_PREFIX("top");
+
+    Verilated::debug(0);
+    Verilated::traceEverOn(true);
+
+    // +direct writes VCD to compare against, +rollover splits the raw file
+    const bool direct = Verilated::commandArgsPlusMatch("direct")[0] != '\0';
+    const bool rollover = Verilated::commandArgsPlusMatch("rollover")[0] != '\0';
+
+    VerilatedVcdC* tfp = new VerilatedVcdC;
+    top->trace(tfp, 99);
+    if (rollover) tfp->rolloverMB(1);
+    if (direct) {
+        tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simx_direct.vcd");
+    } else if (rollover) {
+        tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simx_roll.vtr");
+    } else {
+        tfp->open(VL_STRINGIFY(TEST_OBJ_DIR) "/simx.vtr");
+    }
+
+    top->clk = 0;
+
+    while (main_time < 10000 && !Verilated::gotFinish()) {
+        top->clk = !top->clk;
+        top->eval();
+        tfp->dump((unsigned int)(main_time));
+        ++main_time;
+    }
+    tfp->close();
+    top->final();
+    return 0;
+}
@@ -0,0 +1,59 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_trace_flight.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--trace --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    all_run_flags => ["+direct"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/simx.vtr", qr/^VLTRACE1$/m);
+
+run(cmd => ["../bin/verilator_trace_conv",
+            "--threads", "2",
+            "$Self->{obj_dir}/simx.vtr",
+            "$Self->{obj_dir}/simx.vcd",
+    ]);
+
+file_grep_not("$Self->{obj_dir}/simx.vcd", qr/VLTRACE1/);
+vcd_identical("$Self->{obj_dir}/simx.vcd", "$Self->{obj_dir}/simx_direct.vcd");
+
+# Each rollover file has its own header, so converts on its own
+execute(
+    check_finished => 1,
+    all_run_flags => ["+rollover"],
+    );
+
+my $part = "$Self->{obj_dir}/simx_roll_cat0001.vtr";
+file_grep($part, qr/^VLTRACE1$/m);
+
+run(cmd => ["../bin/verilator_trace_conv",
+            $part,
+            "$Self->{obj_dir}/simx_roll_cat0001.vcd",
+    ]);
+
+file_grep("$Self->{obj_dir}/simx_roll_cat0001.vcd", qr/\$enddefinitions \$end/);
+file_grep("$Self->{obj_dir}/simx_roll_cat0001.vcd", qr/^#\d+$/m);
+
+ok(1);
+1;
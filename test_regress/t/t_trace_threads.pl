@@ -0,0 +1,39 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vltmt => 1);
+
+compile(
+    verilator_flags2 => ['--cc --trace --threads 2 --stats'],
+    );
+
+file_grep($Self->{stats}, qr/Tracing, Parallel change chunks\s+2/i);
+
+execute(
+    check_finished => 1,
+    );
+
+my $threaded_vcd = "$Self->{obj_dir}/simx_threaded.vcd";
+run(cmd => ["cp", "$Self->{obj_dir}/simx.vcd", $threaded_vcd]);
+
+# Serial reference: one thread, so a single change detection chunk
+compile(
+    verilator_flags2 => ['--cc --trace --threads 1'],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# The chunks must together dump exactly what the serial dump does
+vcd_identical($threaded_vcd, "$Self->{obj_dir}/simx.vcd");
+
+ok(1);
+1;
@@ -0,0 +1,31 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (clk);
+   input clk;
+   integer cyc = 0;
+
+   // Enough traced signals for the change detection to be split into
+   // parallel chunks
+
+   genvar g;
+   generate
+      for (g = 0; g < 128; g = g + 1) begin : gen
+         reg [31:0] mem [15:0];
+         always @ (posedge clk) begin
+            mem[cyc[3:0]] <= cyc * (g + 1);
+         end
+      end
+   endgenerate
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
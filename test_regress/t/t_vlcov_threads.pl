@@ -0,0 +1,46 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2020 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(dist => 1);
+
+# Threaded reads must give the same results as t_vlcov_merge and t_vlcov_rank
+run(cmd => ["../bin/verilator_coverage",
+            "--threads", "3",
+            "--write", "$Self->{obj_dir}/coverage.dat",
+            "t/t_vlcov_data_a.dat",
+            "t/t_vlcov_data_b.dat",
+            "t/t_vlcov_data_c.dat",
+            "t/t_vlcov_data_d.dat",
+    ]);
+
+$ENV{LC_ALL} = "C";
+run(cmd => ["sort",
+            "$Self->{obj_dir}/coverage.dat",
+            "> $Self->{obj_dir}/coverage-sort.dat",
+    ]);
+
+files_identical("$Self->{obj_dir}/coverage-sort.dat", "t/t_vlcov_merge.out");
+
+run(cmd => ["../bin/verilator_coverage",
+            "--threads", "3",
+            "--rank",
+            "t/t_vlcov_data_a.dat",
+            "t/t_vlcov_data_b.dat",
+            "t/t_vlcov_data_c.dat",
+            "t/t_vlcov_data_d.dat",
+    ],
+    logfile => "$Self->{obj_dir}/vlcov.log",
+    tee => 0,
+    );
+
+files_identical("$Self->{obj_dir}/vlcov.log", "t/t_vlcov_rank.out");
+
+ok(1);
+1;
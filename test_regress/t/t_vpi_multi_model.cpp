@@ -0,0 +1,110 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+//
+// Copyright 2020 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#include "Vt_vpi_multi_model.h"
+#include "verilated.h"
+#include "verilated_vpi.h"
+
+#include <cstdio>
+#include <cstring>
+
+// __FILE__ is too long
+#define FILENM "t_vpi_multi_model.cpp"
+
+unsigned int main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+#define CHECK_RESULT_NZ(got) \
+    if (!(got)) { \
+        printf("%%Error: %s:%d: GOT = NULL  EXP = !NULL\n", FILENM, __LINE__); \
+        return __LINE__; \
+    }
+
+#define CHECK_RESULT_Z(got) \
+    if (got) { \
+        printf("%%Error: %s:%d: GOT = !NULL  EXP = NULL\n", FILENM, __LINE__); \
+        return __LINE__; \
+    }
+
+#define CHECK_RESULT(got, exp) \
+    if ((got) != (exp)) { \
+        printf("%%Error: %s:%d: GOT = %d   EXP = %d\n", FILENM, __LINE__, (got), (exp)); \
+        return __LINE__; \
+    }
+
+static int getInt(const char* namep) {
+    vpiHandle vh = vpi_handle_by_name(const_cast<PLI_BYTE8*>(namep), NULL);
+    if (!vh) return -1;
+    s_vpi_value v;
+    v.format = vpiIntVal;
+    vpi_get_value(vh, &v);
+    vpi_release_handle(vh);
+    return v.value.integer;
+}
+
+static int check() {
+    Vt_vpi_multi_model* topp = new Vt_vpi_multi_model("top");
+    topp->eval();
+
+    // First lookups build the name index with only the first model
+    vpiHandle vh = vpi_handle_by_name(const_cast<PLI_BYTE8*>("top.t.count"), NULL);
+    CHECK_RESULT_NZ(vh);
+    vpi_release_handle(vh);
+    CHECK_RESULT(getInt("top.t.sub.value"), 0x5a);
+    vh = vpi_handle_by_name(const_cast<PLI_BYTE8*>("top2.t.count"), NULL);
+    CHECK_RESULT_Z(vh);
+
+    // A model made after the index was built must be found
+    Vt_vpi_multi_model* top2p = new Vt_vpi_multi_model("top2");
+    top2p->eval();
+    vh = vpi_handle_by_name(const_cast<PLI_BYTE8*>("top2.t.sub.value"), NULL);
+    CHECK_RESULT_NZ(vh);
+    s_vpi_value v;
+    v.format = vpiIntVal;
+    v.value.integer = 0x33;
+    vpi_put_value(vh, &v, NULL, vpiNoDelay);
+    vpi_release_handle(vh);
+    // Each name resolves within its own model
+    CHECK_RESULT(getInt("top2.t.sub.value"), 0x33);
+    CHECK_RESULT(getInt("top.t.sub.value"), 0x5a);
+
+    // Scope handles from the new model look up their own variables
+    vpiHandle scopeh = vpi_handle_by_name(const_cast<PLI_BYTE8*>("top2.t"), NULL);
+    CHECK_RESULT_NZ(scopeh);
+    vh = vpi_handle_by_name(const_cast<PLI_BYTE8*>("count"), scopeh);
+    CHECK_RESULT_NZ(vh);
+    vpi_release_handle(vh);
+    vpi_release_handle(scopeh);
+
+    // Once destroyed, its names are gone again
+    VL_DO_DANGLING(delete top2p, top2p);
+    vh = vpi_handle_by_name(const_cast<PLI_BYTE8*>("top2.t.count"), NULL);
+    CHECK_RESULT_Z(vh);
+    CHECK_RESULT(getInt("top.t.sub.value"), 0x5a);
+
+    topp->final();
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    Verilated::debug(0);
+    // Failed lookups are expected, don't crash out
+    Verilated::fatalOnVpiError(0);
+
+    int status = check();
+    if (status) {
+        vl_fatal(FILENM, status, "main", "%Error: C Test failed");
+    }
+    printf("*-* All Finished *-*\n");
+    return 0;
+}
@@ -0,0 +1,33 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2020 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   reg [31:0] count /*verilator public_flat_rw*/ = 0;
+
+   sub sub (.clk(clk));
+
+   always @(posedge clk) begin
+      count <= count + 1;
+   end
+
+endmodule
+
+module sub (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   reg [7:0] value /*verilator public_flat_rw*/ = 8'h5a;
+
+endmodule